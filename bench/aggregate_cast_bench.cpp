@@ -0,0 +1,137 @@
+#include "../inc/auto_cast.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// 记录之间的逐字段转换：auto_cast_span与手写逐字段复制对比
+static constexpr std::size_t record_count = std::size_t(1) << 20;
+static constexpr int repeat = 20;
+
+// 内部记录
+struct order
+{
+  std::int64_t id;
+  std::int32_t account;
+  std::int32_t flags;
+  double price;
+  double quantity;
+  std::int64_t timestamp;
+  float fee;
+  std::int16_t venue;
+  std::int16_t side;
+};
+
+// 字段布局相同的存储记录：整条记录一次复制
+struct stored_order
+{
+  std::int64_t id;
+  std::int32_t account;
+  std::int32_t flags;
+  double price;
+  double quantity;
+  std::int64_t timestamp;
+  float fee;
+  std::int16_t venue;
+  std::int16_t side;
+};
+
+// 线上记录：数量和费用类型不同，其余连续字段合并复制
+struct wire_order
+{
+  std::int64_t id;
+  std::int32_t account;
+  std::int32_t flags;
+  double price;
+  std::int32_t quantity;
+  std::int64_t timestamp;
+  double fee;
+  std::int16_t venue;
+  std::int16_t side;
+};
+
+template <>
+struct aggregate_field_mapping<stored_order, order> : positional_field_mapping
+{
+};
+
+template <>
+struct aggregate_field_mapping<wire_order, order> : positional_field_mapping
+{
+};
+
+template <typename Fn>
+double measure_gbps(std::size_t bytes, Fn&& fn)
+{
+  fn();  // 预热
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    fn();
+    asm volatile("" ::: "memory");
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return static_cast<double>(bytes) * repeat / elapsed.count() / 1e9;
+}
+
+template <typename To>
+void copy_fields(const order& from, To& to)
+{
+  to.id = from.id;
+  to.account = from.account;
+  to.flags = from.flags;
+  to.price = from.price;
+  to.quantity = static_cast<decltype(to.quantity)>(from.quantity);
+  to.timestamp = from.timestamp;
+  to.fee = from.fee;
+  to.venue = from.venue;
+  to.side = from.side;
+}
+
+template <typename To>
+void run(const char* name)
+{
+  std::vector<order> orders(record_count);
+  for (std::size_t i = 0; i < orders.size(); ++i) {
+    const auto n = static_cast<std::int64_t>(i);
+    orders[i] = {n,
+                 static_cast<std::int32_t>(n % 97),
+                 0,
+                 100.0 + n % 13,
+                 static_cast<double>(n % 500),
+                 n * 1000,
+                 0.25f,
+                 static_cast<std::int16_t>(n % 7),
+                 static_cast<std::int16_t>(n & 1)};
+  }
+  std::vector<To> converted(record_count);
+  // 读入与写出的字节数之和
+  const std::size_t bytes = record_count * (sizeof(order) + sizeof(To));
+
+  const double bulk = measure_gbps(bytes, [&] {
+    auto_cast_span<To>(orders.data(), converted.data(), orders.size());
+  });
+  const double single = measure_gbps(bytes, [&] {
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+      converted[i] = auto_cast<To>(orders[i]);
+    }
+  });
+  const double manual = measure_gbps(bytes, [&] {
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+      copy_fields(orders[i], converted[i]);
+    }
+  });
+
+  std::printf(
+      "%-13s span %7.2f GB/s  per-record %7.2f GB/s  manual %7.2f GB/s\n", name,
+      bulk, single, manual);
+}
+
+int main()
+{
+  run<stored_order>("order->stored");
+  run<wire_order>("order->wire");
+  return 0;
+}
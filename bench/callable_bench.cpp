@@ -0,0 +1,137 @@
+#include "../inc/auto_cast.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+
+// 回调注册与调用：函数指针 / function_ref与std::function的调用开销和分配次数对比
+static constexpr std::size_t callback_count = 1024;
+static constexpr int repeat = 2000;
+
+static std::size_t allocation_count = 0;
+
+void* operator new(std::size_t size)
+{
+  ++allocation_count;
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// 超过std::function小对象缓冲区的捕获
+struct large_state
+{
+  long values[4];
+};
+
+template <typename Fn>
+double measure_ns(std::size_t operations, Fn&& fn)
+{
+  fn();  // 预热
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    fn();
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / repeat / static_cast<double>(operations);
+}
+
+// 注册callback_count个回调，再逐个调用；报告每次注册的分配次数和每次调用的耗时
+template <typename Callback, typename Make>
+void run(const char* name, Make&& make)
+{
+  std::vector<Callback> callbacks;
+  callbacks.reserve(callback_count);
+  const std::size_t before = allocation_count;
+  for (std::size_t i = 0; i < callback_count; ++i) {
+    callbacks.push_back(make(i));
+  }
+  const double allocations =
+      static_cast<double>(allocation_count - before) / callback_count;
+
+  const double register_ns = measure_ns(callback_count, [&] {
+    callbacks.clear();
+    for (std::size_t i = 0; i < callback_count; ++i) {
+      callbacks.push_back(make(i));
+    }
+  });
+
+  long sink = 0;
+  const double call_ns = measure_ns(callback_count, [&] {
+    for (const Callback& callback : callbacks) {
+      sink += callback(static_cast<int>(sink & 0xff));
+    }
+  });
+  std::printf("%-28s register %6.2f ns  call %5.2f ns  allocations %.2f  (%ld)\n",
+              name, register_ns, call_ns, allocations, sink & 1);
+}
+
+int main()
+{
+  auto captureless = [](int x) -> long { return x * 3 + 1; };
+  run<long (*)(int)>("captureless  auto_cast<fn*>", [&](std::size_t) {
+    return auto_cast<long (*)(int)>(captureless);
+  });
+  run<std::function<long(int)>>("captureless  std::function",
+                                [&](std::size_t) {
+                                  return std::function<long(int)>(captureless);
+                                });
+
+  std::vector<long> offsets(callback_count);
+  for (std::size_t i = 0; i < callback_count; ++i) {
+    offsets[i] = static_cast<long>(i);
+  }
+  std::vector<large_state> states(callback_count);
+  for (std::size_t i = 0; i < callback_count; ++i) {
+    states[i] = large_state{{static_cast<long>(i), 1, 2, 3}};
+  }
+
+  // 捕获一个引用：std::function放得进小对象缓冲区
+  auto small_capture = [&](std::size_t i) {
+    const long* offset = &offsets[i];
+    return [offset](int x) -> long { return x + *offset; };
+  };
+  using small_lambda = decltype(small_capture(0));
+  std::vector<small_lambda> small_lambdas;
+  for (std::size_t i = 0; i < callback_count; ++i) {
+    small_lambdas.push_back(small_capture(i));
+  }
+  run<function_ref<long(int)>>("small capture function_ref", [&](std::size_t i) {
+    return auto_cast<function_ref<long(int)>>(small_lambdas[i]);
+  });
+  run<std::function<long(int)>>("small capture std::function",
+                                [&](std::size_t i) {
+                                  return std::function<long(int)>(
+                                      small_lambdas[i]);
+                                });
+
+  // 按值捕获32字节：std::function需要堆分配
+  auto large_capture = [&](std::size_t i) {
+    large_state state = states[i];
+    return [state](int x) -> long { return x + state.values[0]; };
+  };
+  using large_lambda = decltype(large_capture(0));
+  std::vector<large_lambda> large_lambdas;
+  for (std::size_t i = 0; i < callback_count; ++i) {
+    large_lambdas.push_back(large_capture(i));
+  }
+  run<function_ref<long(int)>>("large capture function_ref", [&](std::size_t i) {
+    return auto_cast<function_ref<long(int)>>(large_lambdas[i]);
+  });
+  run<std::function<long(int)>>("large capture std::function",
+                                [&](std::size_t i) {
+                                  return std::function<long(int)>(
+                                      large_lambdas[i]);
+                                });
+  return 0;
+}
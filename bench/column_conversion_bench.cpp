@@ -0,0 +1,84 @@
+#include "../inc/auto_cast.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// 运行时类型的列转换：convert_column（整列一个内核）与逐元素按类型对分派对比
+static constexpr std::size_t element_count = std::size_t(1) << 16;
+static constexpr int repeat = 2000;
+
+template <typename Fn>
+double measure_ns(Fn&& fn)
+{
+  fn();  // 预热
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    fn();
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / repeat / element_count;
+}
+
+// 原来的写法：每个元素都经过一次按类型对的分派
+template <typename From, std::size_t... I>
+void convert_element_to(column_type to_type, From value, void* to,
+                        std::size_t index, std::index_sequence<I...>)
+{
+  ((static_cast<std::size_t>(to_type) == I
+        ? void(static_cast<std::tuple_element_t<I, column_element_types>*>(
+              to)[index] = auto_cast<
+              std::tuple_element_t<I, column_element_types>>(value))
+        : void()),
+   ...);
+}
+
+template <std::size_t... I>
+void convert_element(column_type from_type, column_type to_type,
+                     const void* from, void* to, std::size_t index,
+                     std::index_sequence<I...>)
+{
+  ((static_cast<std::size_t>(from_type) == I
+        ? convert_element_to(
+              to_type,
+              static_cast<const std::tuple_element_t<I, column_element_types>*>(
+                  from)[index],
+              to, index, std::make_index_sequence<column_type_count>{})
+        : void()),
+   ...);
+}
+
+void run(const char* name, column_type from_type, column_type to_type)
+{
+  std::vector<std::uint64_t> from(element_count);
+  std::vector<std::uint64_t> to(element_count);
+  for (std::size_t i = 0; i < element_count; ++i) {
+    from[i] = i % 100;
+  }
+  // 缓冲区按8字节元素分配，较窄的类型只用到前面一部分；小整数的位模式对各类型都是有效值
+  const double kernel = measure_ns([&] {
+    convert_column(from_type, to_type, from.data(), to.data(), element_count);
+  });
+  const double dispatch = measure_ns([&] {
+    for (std::size_t i = 0; i < element_count; ++i) {
+      convert_element(from_type, to_type, from.data(), to.data(), i,
+                      std::make_index_sequence<column_type_count>{});
+    }
+  });
+  std::printf("%-16s convert_column %6.3f ns/elem  per-element %6.3f ns/elem\n",
+              name, kernel, dispatch);
+}
+
+int main()
+{
+  run("int32->float64", column_type::int32, column_type::float64);
+  run("int64->float32", column_type::int64, column_type::float32);
+  run("uint8->int32", column_type::uint8, column_type::int32);
+  run("float64->int16", column_type::float64, column_type::int16);
+  run("float32->float64", column_type::float32, column_type::float64);
+  run("uint64->uint16", column_type::uint64, column_type::uint16);
+  return 0;
+}
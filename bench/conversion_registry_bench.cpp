@@ -0,0 +1,119 @@
+#include "../inc/auto_cast.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 运行时转换查找：conversion_registry 与 unordered_map + std::function 对比
+struct type_pair_hash
+{
+  std::size_t operator()(
+      const std::pair<std::type_index, std::type_index>& key) const noexcept
+  {
+    return key.first.hash_code() * 31 + key.second.hash_code();
+  }
+};
+
+using function_map =
+    std::unordered_map<std::pair<std::type_index, std::type_index>,
+                       std::function<void(const void*, void*)>,
+                       type_pair_hash>;
+
+struct request
+{
+  std::type_index from;
+  std::type_index to;
+};
+
+template <typename To, typename From>
+void register_pair(conversion_registry& registry, function_map& map)
+{
+  registry.add<To, From>();
+  map.emplace(std::make_pair(std::type_index(typeid(From)),
+                             std::type_index(typeid(To))),
+              [](const void* from, void* to) {
+                *static_cast<To*>(to) =
+                    auto_cast<To>(*static_cast<const From*>(from));
+              });
+}
+
+template <typename Fn>
+double measure_ns(std::size_t operations, Fn&& fn)
+{
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / static_cast<double>(operations);
+}
+
+// 所有注册的类型对都是int64到某个算术类型，源和目标缓冲区可以共用
+void run(const char* name, const conversion_registry& registry,
+         const function_map& map, const std::vector<request>& requests,
+         int repeat)
+{
+  const std::int64_t source = 42;
+  alignas(16) unsigned char target[16] = {};
+  const std::size_t operations = requests.size() * repeat;
+
+  const double registry_ns = measure_ns(operations, [&] {
+    for (int r = 0; r < repeat; ++r) {
+      for (const request& item : requests) {
+        registry.convert(item.from, item.to, &source, target);
+      }
+    }
+  });
+  const double map_ns = measure_ns(operations, [&] {
+    for (int r = 0; r < repeat; ++r) {
+      for (const request& item : requests) {
+        map.find({item.from, item.to})->second(&source, target);
+      }
+    }
+  });
+  std::printf("%-9s registry %6.2f ns/op  unordered_map+function %6.2f ns/op\n",
+              name, registry_ns, map_ns);
+}
+
+int main()
+{
+  conversion_registry registry;
+  function_map map;
+  register_pair<std::int8_t, std::int64_t>(registry, map);
+  register_pair<std::int16_t, std::int64_t>(registry, map);
+  register_pair<std::int32_t, std::int64_t>(registry, map);
+  register_pair<std::uint8_t, std::int64_t>(registry, map);
+  register_pair<std::uint16_t, std::int64_t>(registry, map);
+  register_pair<std::uint32_t, std::int64_t>(registry, map);
+  register_pair<std::uint64_t, std::int64_t>(registry, map);
+  register_pair<float, std::int64_t>(registry, map);
+  register_pair<double, std::int64_t>(registry, map);
+  register_pair<float16, std::int64_t>(registry, map);
+  register_pair<bfloat16, std::int64_t>(registry, map);
+
+  const std::type_index from = typeid(std::int64_t);
+  const std::type_index targets[] = {
+      typeid(std::int8_t),   typeid(std::int16_t),  typeid(std::int32_t),
+      typeid(std::uint8_t),  typeid(std::uint16_t), typeid(std::uint32_t),
+      typeid(std::uint64_t), typeid(float),         typeid(double),
+      typeid(float16),       typeid(bfloat16)};
+
+  // 反序列化中常见的情况：同一列连续出现同一类型对
+  std::vector<request> repeated(1 << 16, request{from, typeid(double)});
+  // 类型对交替出现，每次都需要查表
+  std::vector<request> mixed;
+  std::uint32_t seed = 12345;
+  for (std::size_t i = 0; i < (1 << 16); ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    mixed.push_back({from, targets[(seed >> 16) % std::size(targets)]});
+  }
+
+  run("repeated", registry, map, repeated, 100);
+  run("mixed", registry, map, mixed, 100);
+  return 0;
+}
@@ -0,0 +1,65 @@
+#include "../inc/auto_cast.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+// 半精度批量转换吞吐量：auto_cast_span（SIMD内核）与逐个标量转换对比
+static constexpr std::size_t element_count = std::size_t(1) << 24;
+static constexpr int repeat = 10;
+
+template <typename Fn>
+double measure_gbps(std::size_t bytes, Fn&& fn)
+{
+  fn();  // 预热
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    fn();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return static_cast<double>(bytes) * repeat / elapsed.count() / 1e9;
+}
+
+template <typename Half>
+void run(const char* name, const std::vector<float>& input)
+{
+  std::vector<Half> half(input.size());
+  std::vector<float> output(input.size());
+  // 读入与写出的字节数之和
+  const std::size_t bytes = input.size() * (sizeof(float) + sizeof(Half));
+
+  const double narrow_span = measure_gbps(bytes, [&] {
+    auto_cast_span<Half>(input.data(), half.data(), input.size());
+  });
+  const double narrow_scalar = measure_gbps(bytes, [&] {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      half[i] = auto_cast<Half>(input[i]);
+    }
+  });
+  const double widen_span = measure_gbps(bytes, [&] {
+    auto_cast_span<float>(half.data(), output.data(), half.size());
+  });
+  const double widen_scalar = measure_gbps(bytes, [&] {
+    for (std::size_t i = 0; i < half.size(); ++i) {
+      output[i] = auto_cast<float>(half[i]);
+    }
+  });
+
+  std::printf("%-9s float->half  span %7.2f GB/s  scalar %7.2f GB/s\n", name,
+              narrow_span, narrow_scalar);
+  std::printf("%-9s half->float  span %7.2f GB/s  scalar %7.2f GB/s\n", name,
+              widen_span, widen_scalar);
+}
+
+int main()
+{
+  std::vector<float> input(element_count);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i % 4096) * 0.01f - 20.0f;
+  }
+  run<float16>("float16", input);
+  run<bfloat16>("bfloat16", input);
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include "../inc/auto_cast.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// 结构数组与数组结构互转：auto_cast_span与按记录逐个字段复制的朴素循环对比
+static constexpr std::size_t record_count = std::size_t(1) << 20;
+static constexpr int repeat = 20;
+
+struct record2
+{
+  float f0, f1;
+};
+
+struct record4
+{
+  float f0, f1, f2, f3;
+};
+
+struct record8
+{
+  float f0, f1, f2, f3, f4, f5, f6, f7;
+};
+
+struct record16
+{
+  float f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15;
+};
+
+// 字段需要转换的情况：int32/float读入，int64/double写出
+struct narrow_record
+{
+  std::int32_t id;
+  float x, y, z;
+};
+
+struct wide_record
+{
+  std::int64_t id;
+  double x, y, z;
+};
+
+template <typename Fn>
+double measure_gbps(std::size_t bytes, Fn&& fn)
+{
+  fn();  // 预热
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    fn();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return static_cast<double>(bytes) * repeat / elapsed.count() / 1e9;
+}
+
+template <typename From, typename To, std::size_t... I>
+void naive_to_soa(const std::vector<From>& from, struct_of_arrays<To>& to,
+                  std::index_sequence<I...>)
+{
+  for (std::size_t i = 0; i < from.size(); ++i) {
+    ((to.template column<I>()[i] = static_cast<
+          typename struct_of_arrays<To>::template field_type<I>>(
+          std::get<I>(aggregate_tie(from[i])))),
+     ...);
+  }
+}
+
+template <typename From, typename To, std::size_t... I>
+void naive_to_aos(const struct_of_arrays<From>& from, std::vector<To>& to,
+                  std::index_sequence<I...>)
+{
+  for (std::size_t i = 0; i < to.size(); ++i) {
+    auto fields = aggregate_tie(to[i]);
+    ((std::get<I>(fields) = static_cast<std::remove_reference_t<
+          std::tuple_element_t<I, decltype(fields)>>>(
+          from.template column<I>()[i])),
+     ...);
+  }
+}
+
+template <typename From, typename To>
+void run(const char* name)
+{
+  constexpr std::size_t fields = struct_of_arrays<To>::field_count;
+  std::vector<From> aos(record_count);
+  for (std::size_t i = 0; i < aos.size(); ++i) {
+    std::memset(&aos[i], static_cast<int>(i & 0x7f), sizeof(From));
+  }
+  std::vector<From> back(record_count);
+  struct_of_arrays<To> soa(record_count);
+  // 读入与写出的字节数之和
+  const std::size_t bytes = record_count * (sizeof(From) + sizeof(To));
+
+  const double to_soa = measure_gbps(bytes, [&] {
+    auto_cast_span(aos.data(), soa, aos.size());
+  });
+  const double to_soa_naive = measure_gbps(bytes, [&] {
+    naive_to_soa(aos, soa, std::make_index_sequence<fields>{});
+  });
+  const double to_aos = measure_gbps(bytes, [&] {
+    auto_cast_span(soa, back.data(), back.size());
+  });
+  const double to_aos_naive = measure_gbps(bytes, [&] {
+    naive_to_aos(soa, back, std::make_index_sequence<fields>{});
+  });
+
+  std::printf("%-9s aos->soa %7.2f GB/s  naive %7.2f GB/s\n", name, to_soa,
+              to_soa_naive);
+  std::printf("%-9s soa->aos %7.2f GB/s  naive %7.2f GB/s\n", name, to_aos,
+              to_aos_naive);
+}
+
+int main()
+{
+  run<record2, record2>("float x2");
+  run<record4, record4>("float x4");
+  run<record8, record8>("float x8");
+  run<record16, record16>("float x16");
+  run<narrow_record, wide_record>("widen x4");
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include "../inc/auto_cast.hpp"
+
+#include <chrono>
+#include <codecvt>
+#include <cstddef>
+#include <cstdio>
+#include <locale>
+#include <string>
+#include <string_view>
+
+// Unicode转码：auto_cast、复用输出缓冲区的两遍内核与已弃用的std::wstring_convert
+// 在ASCII为主和中日韩文字为主的文本上的吞吐量对比（按输入字节计）
+static constexpr std::size_t corpus_bytes = std::size_t(4) << 20;
+static constexpr int repeat = 20;
+
+template <typename Fn>
+double measure_gbps(std::size_t bytes, Fn&& fn)
+{
+  fn();  // 预热
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    fn();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return static_cast<double>(bytes) * repeat / elapsed.count() / 1e9;
+}
+
+// 源文件不一定按UTF-8保存，非ASCII字符一律写成通用字符名
+std::string to_utf8(std::u32string_view text)
+{
+  return auto_cast<std::string>(text);
+}
+
+// 以英文为主，偶尔夹带带重音的拉丁字母
+std::string make_ascii_corpus()
+{
+  const std::string_view words[] = {"the ",   "quick ", "brown ", "fox ",
+                                    "jumps ", "over ",  "lazy ",  "dog, ",
+                                    "log\n",  "42 "};
+  const std::string accented[] = {to_utf8(U"caf\u00e9 "),
+                                  to_utf8(U"na\u00efve ")};
+  std::string corpus;
+  for (std::size_t i = 0; corpus.size() < corpus_bytes; ++i) {
+    // 每48个词出现一个非ASCII词
+    corpus += i % 48 == 47 ? std::string_view(accented[(i / 48) % 2])
+                           : words[(i * 7) % 10];
+  }
+  return corpus;
+}
+
+// 以汉字为主，夹带少量ASCII标点、数字和其他中日韩文字
+std::string make_cjk_corpus()
+{
+  const std::u32string_view words[] = {
+      U"\u81ea\u52a8\u8f6c\u6362", U"\u7c7b\u578b",
+      U"\u6570\u636e\u5e93",       U"\u5b57\u7b26\u4e32",
+      U"\u7f16\u7801",             U"\u6027\u80fd\u6d4b\u8bd5",
+      U"\uff0c",                   U"\u3002",
+      U"2024\u5e74",               U"\u65e5\u672c\u8a9e",
+      U"\ud55c\uad6d\uc5b4",       U" "};
+  std::u32string corpus;
+  std::size_t bytes = 0;
+  for (std::size_t i = 0; bytes < corpus_bytes; ++i) {
+    const std::u32string_view word = words[(i * 7 + i / 3) % 12];
+    corpus += word;
+    bytes += to_utf8(word).size();
+  }
+  return to_utf8(corpus);
+}
+
+static std::size_t sink = 0;
+
+// 复用缓冲区时只计两遍内核；std_convert为nullptr时不对比
+template <typename ToChar, typename FromChar, typename StdConvert>
+void run_direction(const char* label, std::basic_string_view<FromChar> from,
+                   StdConvert&& std_convert)
+{
+  using to_string = std::basic_string<ToChar>;
+  to_string buffer = auto_cast<to_string>(from);
+  const std::size_t bytes = from.size() * sizeof(FromChar);
+
+  const double allocating = measure_gbps(
+      bytes, [&] { sink += auto_cast<to_string>(from).size(); });
+  const double reused = measure_gbps(bytes, [&] {
+    sink += measure_unicode<ToChar>(from.data(), from.size()).length;
+    transcode_unicode(from.data(), from.size(), &buffer[0]);
+  });
+  std::printf("  %-14s auto_cast %6.2f GB/s  reused buffer %6.2f GB/s", label,
+              allocating, reused);
+  if constexpr (!std::is_null_pointer_v<std::decay_t<StdConvert>>) {
+    const double standard =
+        measure_gbps(bytes, [&] { sink += std_convert().size(); });
+    std::printf("  wstring_convert %6.2f GB/s", standard);
+  }
+  std::printf("\n");
+}
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+void run(const char* name, const std::string& utf8)
+{
+  const std::u16string utf16 =
+      auto_cast<std::u16string>(std::string_view(utf8));
+  const std::u32string utf32 =
+      auto_cast<std::u32string>(std::string_view(utf8));
+  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
+      utf16_convert;
+  std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> utf32_convert;
+
+  std::size_t ascii = 0;
+  for (char32_t code_point : utf32) {
+    ascii += code_point < 0x80;
+  }
+  std::printf("%s (%zu code points, %.1f%% ASCII)\n", name, utf32.size(),
+              100.0 * static_cast<double>(ascii) /
+                  static_cast<double>(utf32.size()));
+
+  run_direction<char16_t>("utf8 -> utf16", std::string_view(utf8),
+                          [&] { return utf16_convert.from_bytes(utf8); });
+  run_direction<char>("utf16 -> utf8", std::u16string_view(utf16),
+                      [&] { return utf16_convert.to_bytes(utf16); });
+  run_direction<char32_t>("utf8 -> utf32", std::string_view(utf8),
+                          [&] { return utf32_convert.from_bytes(utf8); });
+  run_direction<char>("utf32 -> utf8", std::u32string_view(utf32),
+                      [&] { return utf32_convert.to_bytes(utf32); });
+  run_direction<char32_t>("utf16 -> utf32", std::u16string_view(utf16),
+                          nullptr);
+  run_direction<char16_t>("utf32 -> utf16", std::u32string_view(utf32),
+                          nullptr);
+}
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+int main()
+{
+  run("ASCII-heavy", make_ascii_corpus());
+  run("CJK-heavy", make_cjk_corpus());
+  return sink == 0;
+}
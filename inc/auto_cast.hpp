@@ -1,29 +1,64 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <typeindex>
 #include <typeinfo>
+#include <utility>
+#ifdef AUTO_CAST_RECORD_DOWN_CAST_PROFILE
+#include <cstdlib>
+#include <map>
+#include <ostream>
+#include <vector>
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#endif
+#endif
+#if __cplusplus >= 202002
+#include <ranges>
+#include <span>
+#endif
+
+#if !defined(AUTO_CAST_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define AUTO_CAST_X86_SIMD 1
+#include <immintrin.h>
+#endif
 
 #define CPP_20 __cplusplus >= 202002
 #define CPP_17 __cplusplus >= 201703
 #define CPP_14 __cplusplus >= 201402
 #define CPP_11 __cplusplus >= 201103
 /*
-/ ģ幤
-/ cpp汾ѡʹõģ
+/ 模板工具
+/ 根据cpp版本选择使用的模板
 */
 
 #if CPP_20
-// ָͼ
+// 指针类型检查
 template <typename T>
 concept is_pointer_like = std::is_pointer_v<T>;
 
 template <typename T>
 constexpr bool is_pointer_like_v = is_pointer_like<T>;
 
-// ͵ļ
+// 引用类型的检查
 template <typename T>
 concept is_reference_like = std::is_reference_v<T>;
 
@@ -64,7 +99,7 @@ concept is_standard_pointer_integer_conversion =
 
 #elif CPP_17
 
-// ָͼ
+// 指针类型检查
 template <typename T>
 struct is_pointer_like
 {
@@ -98,7 +133,7 @@ struct is_pointer_like<T* const volatile>
 template <typename T>
 constexpr bool is_pointer_like_v = is_pointer_like<T>::value;
 
-// ͵ļ
+// 引用类型的检查
 template <typename T>
 struct is_reference_like
 {
@@ -152,7 +187,7 @@ constexpr bool is_standard_pointer_integer_conversion =
     PointerToStandardInteger<From, To> || StandardIntegerToPointer<From, To>;
 
 #elif CPP_14
-// ָͼ
+// 指针类型检查
 template <typename T>
 struct is_pointer_like
 {
@@ -186,7 +221,7 @@ struct is_pointer_like<T* const volatile>
 template <typename T>
 constexpr bool is_pointer_like_v = is_pointer_like<T>::value;
 
-// ͵ļ
+// 引用类型的检查
 template <typename T>
 struct is_reference_like
 {
@@ -241,18 +276,24 @@ constexpr bool is_standard_pointer_integer_conversion =
 
 #endif
 
-// Աǩ
+// 策略标签
 struct safe_cast_tag
 {
-};  // ȫģʽֹreinterpret_cast
+};  // 安全模式，禁止reinterpret_cast
 struct unsafe_cast_tag
 {
-};  // ȫģʽreinterpret_cast
+};  // 不安全模式，允许reinterpret_cast
 struct strict_cast_tag
 {
-};  // ϸģʽֹĳЩת
+};  // 严格模式，禁止某些转换
+struct assert_checked_cast_tag
+{
+};  // 调试检查模式，发布版本不检查向下转换
+struct zero_overhead_cast_tag
+{
+};  // 零开销模式，只允许至多一次寄存器移动加偏移的转换
 
-// Ĭģʽȫģʽ
+// 默认模式：安全模式
 struct default_policy
 {
   using tag = safe_cast_tag;
@@ -260,9 +301,10 @@ struct default_policy
   static constexpr bool allow_const_removal = true;
   static constexpr bool allow_non_polymorphic_downcast = false;
   static constexpr bool allow_standard_pointer_integer_cast = true;
+  static constexpr bool allow_pointer_bit_drop = true;
 };
 
-// ȫģʽ
+// 不安全模式策略
 struct unsafe_policy
 {
   using tag = unsafe_cast_tag;
@@ -270,585 +312,5221 @@ struct unsafe_policy
   static constexpr bool allow_const_removal = true;
   static constexpr bool allow_non_polymorphic_downcast = true;
   static constexpr bool allow_standard_pointer_integer_cast = true;
+  static constexpr bool allow_pointer_bit_drop = true;
 };
 
-// ϸģʽ
+// 严格模式策略
 struct strict_policy
 {
   using tag = strict_cast_tag;
   static constexpr bool allow_reinterpret = false;
-  static constexpr bool allow_const_removal = false;  // ֹȥconst
+  static constexpr bool allow_const_removal = false;  // 禁止去const
   static constexpr bool allow_non_polymorphic_downcast =
-      false;  // ֹǶ̬ת
+      false;  // 禁止非多态向下转换
   static constexpr bool allow_standard_pointer_integer_cast =
-      false;  // ָֹ໥ת
+      false;  // 禁止指针和整数相互转换
+  static constexpr bool allow_pointer_bit_drop =
+      false;  // 禁止丢弃指针中打包的标签位
 };
 
-#if __cplusplus >= 202002
+// 调试检查模式策略：多态向下转换在调试版本中用dynamic_cast并断言，
+// 定义NDEBUG时直接static_cast
+struct assert_checked_policy
+{
+  using tag = assert_checked_cast_tag;
+  static constexpr bool allow_reinterpret = false;
+  static constexpr bool allow_const_removal = true;
+  static constexpr bool allow_non_polymorphic_downcast = false;
+  static constexpr bool allow_standard_pointer_integer_cast = true;
+  static constexpr bool allow_pointer_bit_drop = true;
+  static constexpr bool assert_checked_downcast = true;
+};
 
-template <typename To, typename From, is_cast_policy Policy = default_policy>
-class auto_cast_impl
+// 策略是否要求断言检查的向下转换（未声明该标志的策略视为false）
+template <typename Policy, typename = void>
+struct is_assert_checked_policy : std::false_type
 {
-private:
-  // ʹòԱ־
-  static constexpr bool allow_reinterpret = Policy::allow_reinterpret;
-  static constexpr bool allow_const_removal = Policy::allow_const_removal;
-  static constexpr bool allow_non_polymorphic_downcast =
-      Policy::allow_non_polymorphic_downcast;
-  static constexpr bool allow_standard_pointer_integer_cast =
-      Policy::allow_standard_pointer_integer_cast;
+};
 
-  // ʱϢ
-  template <bool Condition>
-  struct static_check
-  {
-    static_assert(
-        Condition,
-        "auto_cast<>: This conversion is not allowed by the current policy");
-  };
+template <typename Policy>
+struct is_assert_checked_policy<
+    Policy, std::enable_if_t<Policy::assert_checked_downcast>>
+    : std::true_type
+{
+};
 
-  // ʱϢضreinterpret_cast
-  struct reinterpret_not_allowed
-  {
-    static_assert(
-        allow_reinterpret,
-        "auto_cast<>: reinterpret_cast is not allowed by the current policy. "
-        "Consider using auto_cast<To, unsafe_policy> or auto_cast_unsafe<To>.");
-  };
+// 零开销模式策略：用于延迟敏感的代码，任何可能产生额外开销的转换都在编译时报错
+struct zero_overhead_policy
+{
+  using tag = zero_overhead_cast_tag;
+  static constexpr bool allow_reinterpret = false;
+  static constexpr bool allow_const_removal = true;
+  static constexpr bool allow_non_polymorphic_downcast = false;
+  static constexpr bool allow_standard_pointer_integer_cast = true;
+  static constexpr bool allow_pointer_bit_drop = true;
+  static constexpr bool require_zero_overhead = true;
+};
 
-  // ʱϢضȥconst
-  struct const_removal_not_allowed
-  {
-    static_assert(allow_const_removal,
-                  "auto_cast<>: Removing const qualification is not allowed by "
-                  "the current policy. "
-                  "Consider using auto_cast<To, default_policy> instead of "
-                  "auto_cast<To, strict_policy>.");
-  };
+// 策略是否只允许零开销转换（未声明该标志的策略视为false）
+template <typename Policy, typename = void>
+struct is_zero_overhead_policy : std::false_type
+{
+};
 
-  // ʱϢضڷǶ̬ת
-  struct non_polymorphic_downcast_not_allowed
+template <typename Policy>
+struct is_zero_overhead_policy<Policy,
+                               std::enable_if_t<Policy::require_zero_overhead>>
+    : std::true_type
+{
+};
+
+// 判断能否用static_cast完成向下转换（虚基类或有歧义的基类不行）
+template <typename To, typename From, typename = void>
+struct is_static_down_castable : std::false_type
+{
+};
+
+template <typename To, typename From>
+struct is_static_down_castable<
+    To, From, std::void_t<decltype(static_cast<To>(std::declval<From>()))>>
+    : std::true_type
+{
+};
+
+// 策略是否允许丢弃打包指针中的标签位（未声明该标志的策略视为true）
+template <typename Policy, typename = void>
+struct policy_allows_pointer_bit_drop : std::true_type
+{
+};
+
+template <typename Policy>
+struct policy_allows_pointer_bit_drop<
+    Policy, std::void_t<decltype(Policy::allow_pointer_bit_drop)>>
+    : std::bool_constant<Policy::allow_pointer_bit_drop>
+{
+};
+
+// 向下转换的类型分布：由write_down_cast_profile生成的头文件特化，
+// expected按出现次数列出最常见的动态类型（一般一到两个）
+// 生成的头文件需要在所有用到对应转换的翻译单元中、类型定义之后包含
+template <typename To, typename From>
+struct down_cast_profile
+{
+  using expected = std::tuple<>;
+};
+
+#ifdef AUTO_CAST_RECORD_DOWN_CAST_PROFILE
+// 记录模式：统计每个(目标类型, 源类型)转换点上成功转换的动态类型
+class down_cast_profiler
+{
+public:
+  static down_cast_profiler& instance()
   {
-    static_assert(allow_non_polymorphic_downcast,
-                  "auto_cast<>: Non-polymorphic downcast is not allowed by the "
-                  "current policy. "
-                  "Consider using auto_cast<To, default_policy> instead of "
-                  "auto_cast<To, strict_policy>.");
-  };
+    static down_cast_profiler profiler;
+    return profiler;
+  }
 
-  struct standard_pointer_integer_cast_not_allowed
+  void record(const std::type_info& to, const std::type_info& from,
+              const std::type_info& dynamic_type)
   {
-    static_assert(
-        allow_standard_pointer_integer_cast,
-        "auto_cast<>: standard pointer integer cast is not allowed by the "
-        "current policy. "
-        "Consider using auto_cast<To, default_policy> instead of "
-        "auto_cast<To, strict_policy>.");
-  };
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++sites_[{std::type_index(to), std::type_index(from)}][dynamic_type];
+  }
 
-  // תʵ
-  template <typename T = To, typename F = From>
-  static T same_type_cast(F from) noexcept
-    requires(std::is_same_v<T, F>)
+  // 输出down_cast_profile特化，每个转换点保留出现最多的top个动态类型；
+  // 无法在其他翻译单元中命名的类型（匿名命名空间、局部类）被跳过
+  void write(std::ostream& out, std::size_t top = 2) const
   {
-    return from;
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << "// generated by write_down_cast_profile, do not edit\n"
+           "#pragma once\n";
+    for (const auto& site : sites_) {
+      std::string to = type_name(site.first.first);
+      std::string from = type_name(site.first.second);
+      if (!is_nameable(to) || !is_nameable(from)) {
+        continue;
+      }
+
+      std::vector<std::pair<std::uint64_t, std::string>> ranked;
+      std::uint64_t total = 0;
+      for (const auto& entry : site.second) {
+        total += entry.second;
+        std::string name = type_name(entry.first);
+        if (is_nameable(name)) {
+          ranked.emplace_back(entry.second, std::move(name));
+        }
+      }
+      std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+      });
+      if (ranked.size() > top) {
+        ranked.resize(top);
+      }
+      if (ranked.empty()) {
+        continue;
+      }
+
+      out << "\n// " << total << " casts:";
+      for (const auto& entry : ranked) {
+        out << " " << entry.second << " "
+            << (100.0 * static_cast<double>(entry.first) /
+                static_cast<double>(total))
+            << "%";
+      }
+      out << "\ntemplate <>\nstruct down_cast_profile<" << to << ", " << from
+          << ">\n{\n  using expected = std::tuple<";
+      for (std::size_t i = 0; i < ranked.size(); ++i) {
+        out << (i ? ", " : "") << ranked[i].second;
+      }
+      out << ">;\n};\n";
+    }
   }
 
-  // ȥconstתԣ
-  template <typename T = To, typename F = From>
-  static T remove_const_cast(F from) noexcept
-    requires(std::is_same_v<std::remove_const_t<T>, std::remove_const_t<F>> &&
-             !std::is_same_v<T, F> && !static_cast<bool>(std::is_const_v<T>) &&
-             static_cast<bool>(std::is_const_v<F>))
+private:
+  static std::string type_name(std::type_index type)
   {
-    static_check<allow_const_removal> check;
-    return const_cast<T>(from);
+#if defined(__GNUC__) || defined(__clang__)
+    int status = 0;
+    std::unique_ptr<char, void (*)(void*)> demangled(
+        abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), std::free);
+    if (status == 0 && demangled) {
+      return demangled.get();
+    }
+#endif
+    std::string name = type.name();
+    for (const char* prefix : {"class ", "struct "}) {
+      if (name.compare(0, std::strlen(prefix), prefix) == 0) {
+        name.erase(0, std::strlen(prefix));
+      }
+    }
+    return name;
   }
 
-  // ת
-  template <typename T = To, typename F = From>
-  static T up_cast(F from) noexcept
-    requires(
-        std::is_base_of_v<std::remove_pointer_t<F>, std::remove_pointer_t<T>> &&
-        (is_pointer_like_v<T> && is_pointer_like_v<F>))
+  static bool is_nameable(const std::string& name)
   {
-    return static_cast<T>(from);
+    return name.find("(anonymous") == std::string::npos &&
+           name.find("`anonymous") == std::string::npos &&
+           name.find('{') == std::string::npos &&
+           name.find("::<lambda") == std::string::npos;
   }
 
-  template <typename T = To, typename F = From>
-  static T up_cast(F from) noexcept
-    requires(std::is_base_of_v<T, F> &&
-             (is_reference_like_v<T> && is_reference_like_v<F>))
+  mutable std::mutex mutex_;
+  std::map<std::pair<std::type_index, std::type_index>,
+           std::map<std::type_index, std::uint64_t>>
+      sites_;
+};
+
+// 把记录到的类型分布写成头文件，供下一次构建包含
+inline void write_down_cast_profile(std::ostream& out, std::size_t top = 2)
+{
+  down_cast_profiler::instance().write(out, top);
+}
+#endif
+
+// 按预期动态类型推测的向下转换：typeid精确匹配时用static_cast，否则回退到dynamic_cast
+// To、From都是指针；预期类型必须能从From静态向下转换并隐式转换为To，否则忽略
+template <typename To, typename From, typename Expected>
+struct is_speculative_down_cast_target
+    : std::bool_constant<
+          is_static_down_castable<
+              std::add_pointer_t<std::conditional_t<
+                  std::is_const_v<std::remove_pointer_t<From>>,
+                  std::add_const_t<Expected>, Expected>>,
+              From>::value &&
+          std::is_convertible_v<
+              std::add_pointer_t<std::conditional_t<
+                  std::is_const_v<std::remove_pointer_t<From>>,
+                  std::add_const_t<Expected>, Expected>>,
+              To>>
+{
+};
+
+template <typename To, typename From>
+bool speculative_down_cast(From, const std::type_info&, To&, std::tuple<>*)
+{
+  return false;
+}
+
+template <typename To, typename From, typename Expected, typename... Rest>
+bool speculative_down_cast(From from, const std::type_info& dynamic_type,
+                           To& result, std::tuple<Expected, Rest...>*)
+{
+  if constexpr (is_speculative_down_cast_target<To, From, Expected>::value) {
+    if (dynamic_type == typeid(Expected)) {
+      using expected_pointer = std::add_pointer_t<
+          std::conditional_t<std::is_const_v<std::remove_pointer_t<From>>,
+                             std::add_const_t<Expected>, Expected>>;
+      result = static_cast<expected_pointer>(from);
+      return true;
+    }
+  }
+  return speculative_down_cast(from, dynamic_type, result,
+                               static_cast<std::tuple<Rest...>*>(nullptr));
+}
+
+template <typename To, typename From>
+To profiled_down_cast(From from)
+{
+#ifdef AUTO_CAST_RECORD_DOWN_CAST_PROFILE
+  To recorded = dynamic_cast<To>(from);
+  if (recorded) {
+    down_cast_profiler::instance().record(
+        typeid(std::remove_pointer_t<To>), typeid(std::remove_pointer_t<From>),
+        typeid(*from));
+  }
+  return recorded;
+#else
+  using profile = typename down_cast_profile<
+      std::remove_cv_t<std::remove_pointer_t<To>>,
+      std::remove_cv_t<std::remove_pointer_t<From>>>::expected;
+  if constexpr (std::tuple_size_v<profile> > 0) {
+    To result = nullptr;
+    if (from && speculative_down_cast(from, typeid(*from), result,
+                                      static_cast<profile*>(nullptr))) {
+      return result;
+    }
+  }
+  return dynamic_cast<To>(from);
+#endif
+}
+
+constexpr unsigned pointer_alignment_bits(std::size_t alignment) noexcept
+{
+  unsigned bits = 0;
+  while (alignment > 1) {
+    alignment >>= 1;
+    ++bits;
+  }
+  return bits;
+}
+
+// 带标签指针：低LowBits位借用对齐位，高HighBits位借用64位地址中未使用的高位
+// T可以是不完整类型，对齐检查推迟到成员函数实例化时
+template <typename T, unsigned LowBits, unsigned HighBits = 0>
+class tagged_ptr
+{
+public:
+  using element_type = T;
+  static constexpr unsigned tag_bits = LowBits + HighBits;
+
+  tagged_ptr() noexcept = default;
+
+  explicit tagged_ptr(T* ptr, std::uintptr_t tag = 0) noexcept
   {
-    return static_cast<T>(from);
+    reset(ptr, tag);
   }
 
-  // ת - ̬dynamic_cast
-  template <typename T = To, typename F = From>
-  static T safe_down_cast(F from)
-    requires(
-        std::is_base_of_v<std::remove_pointer_t<F>, std::remove_pointer_t<T>> &&
-        std::is_polymorphic_v<std::remove_pointer_t<F>> &&
-        (is_pointer_like_v<T> && is_pointer_like_v<F>))
+  T* get() const noexcept
   {
-    auto result = dynamic_cast<T>(from);
-    if (!result && from) {
-      throw std::bad_cast();
+    check_layout();
+    std::uintptr_t address = bits_ & address_mask();
+    if constexpr (HighBits > 0) {
+      // 恢复规范地址（符号扩展）
+      address = static_cast<std::uintptr_t>(
+          static_cast<std::intptr_t>(address << HighBits) >> HighBits);
     }
-    return result;
+    return reinterpret_cast<T*>(address);
   }
 
-  template <typename T = To, typename F = From>
-  static T safe_down_cast(F from)
-    requires(std::is_base_of_v<F, T> && std::is_polymorphic_v<F> &&
-             (is_reference_like_v<T> && is_reference_like_v<F>))
+  std::uintptr_t tag() const noexcept
   {
-    using raw_to = std::remove_reference_t<T>;
-    using raw_from = std::remove_reference_t<F>;
-    auto* ptr = dynamic_cast<raw_to*>(&from);
-    if (!ptr) {
-      throw std::bad_cast();
+    std::uintptr_t tag = bits_ & low_mask();
+    if constexpr (HighBits > 0) {
+      tag |= (bits_ >> (address_width - HighBits)) << LowBits;
     }
-    return static_cast<T>(*ptr);
+    return tag;
   }
 
-  // ת - Ƕ̬static_castԣ
-  template <typename T = To, typename F = From>
-  static T unsafe_down_cast(F from) noexcept
-    requires(
-        std::is_base_of_v<std::remove_pointer_t<F>, std::remove_pointer_t<T>> &&
-        !std::is_polymorphic_v<std::remove_pointer_t<F>> &&
-        (is_pointer_like_v<T> || is_reference_like_v<T>) &&
-        (is_pointer_like_v<F> || is_reference_like_v<F>))
+  void set_tag(std::uintptr_t tag) noexcept
   {
-    static_check<allow_non_polymorphic_downcast> check;
-    return static_cast<T>(from);
+    assert(tag <= max_tag() && "tagged_ptr<>: tag does not fit");
+    bits_ = (bits_ & address_mask()) | encode_tag(tag);
   }
 
-  // ׼ת
-  template <typename T = To, typename F = From>
-  static T standard_cast(F from) noexcept(noexcept(static_cast<T>(from)))
-    requires(!std::is_same_v<T, F> && std::is_convertible_v<F, T> &&
-             !std::is_base_of_v<T, F> && !std::is_base_of_v<F, T> &&
-             !std::is_const_v<F>)
+  void reset(T* ptr, std::uintptr_t tag = 0) noexcept
   {
-    return static_cast<T>(from);
+    check_layout();
+    assert(tag <= max_tag() && "tagged_ptr<>: tag does not fit");
+    bits_ = (reinterpret_cast<std::uintptr_t>(ptr) & address_mask()) |
+            encode_tag(tag);
+    assert(get() == ptr && "tagged_ptr<>: pointer uses the tag bits");
   }
 
-  // ǿ½תԣ
-  template <typename T = To, typename F = From>
-  static T reinterpret_cast_impl(F from) noexcept
-    requires(allow_reinterpret &&
-             ((is_pointer_like_v<T> && is_pointer_like_v<F>) ||
-              (std::is_integral_v<T> && is_pointer_like_v<F>) ||
-              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+  std::uintptr_t raw() const noexcept { return bits_; }
+
+  T& operator*() const noexcept { return *get(); }
+  T* operator->() const noexcept { return get(); }
+  explicit operator bool() const noexcept { return get() != nullptr; }
+
+  friend bool operator==(const tagged_ptr& lhs, const tagged_ptr& rhs) noexcept
   {
-    return reinterpret_cast<T>(from);
+    return lhs.bits_ == rhs.bits_;
   }
-
-  // reinterpret_castİ汾
-  template <typename T = To, typename F = From>
-  static T reinterpret_cast_impl(F /*unused*/) noexcept
-    requires(!allow_reinterpret &&
-             ((is_pointer_like_v<T> && is_pointer_like_v<F>) ||
-              (std::is_integral_v<T> && is_pointer_like_v<F>) ||
-              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+  friend bool operator!=(const tagged_ptr& lhs, const tagged_ptr& rhs) noexcept
   {
-    // ʱ
-    reinterpret_not_allowed error;
-    return T{};
+    return lhs.bits_ != rhs.bits_;
   }
 
-  template <typename T = To, typename F = From>
-  static T standard_pointer_integer_cast(F from) noexcept
-    requires(allow_standard_pointer_integer_cast &&
-             ((std::is_integral_v<T> && is_pointer_like_v<F>) ||
-              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+  static constexpr std::uintptr_t max_tag() noexcept
   {
-    return reinterpret_cast<T>(from);
+    return (std::uintptr_t(1) << tag_bits) - 1;
   }
 
-  template <typename T = To, typename F = From>
-  static T standard_pointer_integer_cast(F /*from*/) noexcept
-    requires(!allow_standard_pointer_integer_cast &&
-             ((std::is_integral_v<T> && is_pointer_like_v<F>) ||
-              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+private:
+  static constexpr unsigned address_width = sizeof(std::uintptr_t) * 8;
+
+  static constexpr std::uintptr_t low_mask() noexcept
   {
-    standard_pointer_integer_cast_not_allowed error;
-    return T{};
+    return (std::uintptr_t(1) << LowBits) - 1;
   }
 
-public:
-  static To cast(From from)
+  static constexpr std::uintptr_t address_mask() noexcept
   {
-    // ȼԲͬת
-    if constexpr (std::is_same_v<To, From>) {
-      return same_type_cast(from);
+    if constexpr (HighBits > 0) {
+      return ~low_mask() & (~std::uintptr_t(0) >> HighBits);
     }
-    else if constexpr (std::is_same_v<std::remove_const_t<To>,
-                                      std::remove_const_t<From>>) {
-      // ֻconstͬ
-      if constexpr (std::is_const_v<From> && !std::is_const_v<To>) {
-        return remove_const_cast(from);
-      }
-      else {
-        return static_cast<To>(from);
-      }
+    else {
+      return ~low_mask();
     }
-    else if constexpr (std::is_base_of_v<std::remove_pointer_t<To>,
-                                         std::remove_pointer_t<From>>) {
-      // תǰȫ
-      return up_cast(from);
+  }
+
+  static constexpr std::uintptr_t encode_tag(std::uintptr_t tag) noexcept
+  {
+    std::uintptr_t bits = tag & low_mask();
+    if constexpr (HighBits > 0) {
+      bits |= (tag >> LowBits) << (address_width - HighBits);
     }
-    else if constexpr (std::is_base_of_v<std::remove_pointer_t<From>,
-                                         std::remove_pointer_t<To>>) {
-      // ת
-      if constexpr (std::is_polymorphic_v<std::remove_pointer_t<From>>) {
-        return safe_down_cast(from);
-      }
-      else {
-        return unsafe_down_cast(from);
-      }
+    return bits;
+  }
+
+  static constexpr void check_layout() noexcept
+  {
+    static_assert(alignof(T) >= (std::size_t(1) << LowBits),
+                  "tagged_ptr<>: alignment of T is too small for the "
+                  "requested number of low tag bits");
+    static_assert(HighBits == 0 || address_width == 64,
+                  "tagged_ptr<>: high tag bits require 64-bit pointers");
+    static_assert(HighBits <= 16,
+                  "tagged_ptr<>: at most 16 high bits are unused by "
+                  "64-bit addresses");
+  }
+
+  std::uintptr_t bits_ = 0;
+};
+
+// 压缩指针使用的默认堆基址，所有压缩指针相对该地址保存32位偏移
+struct compressed_heap
+{
+  static void set_base(const void* base) noexcept
+  {
+    base_ = reinterpret_cast<std::uintptr_t>(base);
+  }
+
+  static std::uintptr_t base() noexcept { return base_; }
+
+private:
+  inline static std::uintptr_t base_ = 0;
+};
+
+// 32位压缩指针：保存 (ptr - Heap::base()) >> log2(alignof(T)) 再加1，0表示空指针
+template <typename T, typename Heap = compressed_heap>
+class compressed_ptr
+{
+public:
+  using element_type = T;
+
+  compressed_ptr() noexcept = default;
+
+  // 超出压缩堆范围的指针无法表示，抛出std::bad_cast（发布版本同样检查）
+  explicit compressed_ptr(T* ptr)
+  {
+    if (!representable(ptr)) {
+      throw std::bad_cast();
     }
-    else if constexpr (std::is_convertible_v<From, To>) {
-      // ׼ת
-      return standard_cast(from);
+    bits_ = encode(ptr);
+  }
+
+  // 指针是否能无损压缩（位于堆基址之后的可寻址范围内）
+  static bool representable(T* ptr) noexcept
+  {
+    if (!ptr) {
+      return true;
     }
-    else if constexpr (is_standard_pointer_integer_conversion<From, To>) {
-      return standard_pointer_integer_cast(from);
+    const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    const std::uintptr_t base = Heap::base();
+    if (address < base) {
+      return false;
     }
-    else if constexpr ((is_pointer_like_v<To> && is_pointer_like_v<From>) ||
-                       (std::is_integral_v<To> && is_pointer_like_v<From>) ||
-                       (is_pointer_like_v<To> && std::is_integral_v<From>)) {
-      // ǿ½ת
-      return reinterpret_cast_impl(from);
+    const std::uintptr_t offset = address - base;
+    return (offset & ((std::uintptr_t(1) << shift()) - 1)) == 0 &&
+           (offset >> shift()) < std::uintptr_t(UINT32_MAX);
+  }
+
+  T* get() const noexcept
+  {
+    if (bits_ == 0) {
+      return nullptr;
     }
-    else {
-      static_assert(sizeof(From) == 0,
-                    "auto_cast<>: No suitable conversion found between types");
+    return reinterpret_cast<T*>(
+        Heap::base() + (static_cast<std::uintptr_t>(bits_ - 1) << shift()));
+  }
+
+  std::uint32_t raw() const noexcept { return bits_; }
+
+  T& operator*() const noexcept { return *get(); }
+  T* operator->() const noexcept { return get(); }
+  explicit operator bool() const noexcept { return bits_ != 0; }
+
+  friend bool operator==(const compressed_ptr& lhs,
+                         const compressed_ptr& rhs) noexcept
+  {
+    return lhs.bits_ == rhs.bits_;
+  }
+  friend bool operator!=(const compressed_ptr& lhs,
+                         const compressed_ptr& rhs) noexcept
+  {
+    return lhs.bits_ != rhs.bits_;
+  }
+
+private:
+  static constexpr unsigned shift() noexcept
+  {
+    return pointer_alignment_bits(alignof(T));
+  }
+
+  static std::uint32_t encode(T* ptr) noexcept
+  {
+    if (!ptr) {
+      return 0;
     }
+    const std::uintptr_t offset =
+        reinterpret_cast<std::uintptr_t>(ptr) - Heap::base();
+    return static_cast<std::uint32_t>((offset >> shift()) + 1);
   }
-};
 
-#elif CPP_11
+  std::uint32_t bits_ = 0;
+};
 
-// תǩ
-struct same_type_tag
+// 打包指针特征：描述与裸指针之间的转换，以及解包时是否会丢弃信息
+template <typename P>
+struct packed_pointer_traits
 {
+  static constexpr bool value = false;
 };
-struct up_cast_tag
+
+template <typename T, unsigned LowBits, unsigned HighBits>
+struct packed_pointer_traits<tagged_ptr<T, LowBits, HighBits>>
 {
+  static constexpr bool value = true;
+  static constexpr bool lossy_unpack = true;  // 解包会丢弃标签位
+  using element_type = T;
+
+  static tagged_ptr<T, LowBits, HighBits> pack(T* ptr) noexcept
+  {
+    return tagged_ptr<T, LowBits, HighBits>(ptr);
+  }
 };
-struct down_cast_polymorphic_tag
+
+template <typename T, typename Heap>
+struct packed_pointer_traits<compressed_ptr<T, Heap>>
 {
+  static constexpr bool value = true;
+  static constexpr bool lossy_unpack = false;
+  using element_type = T;
+
+  // 范围检查在构造函数中完成，超出压缩堆范围时抛出std::bad_cast
+  static compressed_ptr<T, Heap> pack(T* ptr)
+  {
+    return compressed_ptr<T, Heap>(ptr);
+  }
 };
-struct down_cast_non_polymorphic_tag
+
+template <typename To, typename From>
+constexpr bool is_pointer_to_packed_conversion() noexcept
 {
-};
-struct const_removal_tag
+  using traits = packed_pointer_traits<std::remove_cv_t<To>>;
+  if constexpr (traits::value && std::is_pointer<From>::value) {
+    return std::is_convertible<From, typename traits::element_type*>::value;
+  }
+  else {
+    return false;
+  }
+}
+
+template <typename To, typename From>
+constexpr bool is_packed_to_pointer_conversion() noexcept
 {
-};
-struct standard_pointer_integer_tag
+  using traits = packed_pointer_traits<std::remove_cv_t<From>>;
+  if constexpr (traits::value && std::is_pointer<To>::value) {
+    return std::is_convertible<typename traits::element_type*, To>::value;
+  }
+  else {
+    return false;
+  }
+}
+
+// 解包是否会丢弃信息
+template <typename From>
+constexpr bool is_lossy_packed_pointer() noexcept
 {
-};
-struct generic_pointer_integer_tag
+  using traits = packed_pointer_traits<std::remove_cv_t<From>>;
+  if constexpr (traits::value) {
+    return traits::lossy_unpack;
+  }
+  else {
+    return false;
+  }
+}
+
+template <typename To, typename From>
+To packed_pointer_cast(From from)
+{
+  if constexpr (is_pointer_to_packed_conversion<To, From>()) {
+    using traits = packed_pointer_traits<std::remove_cv_t<To>>;
+    return traits::pack(static_cast<typename traits::element_type*>(from));
+  }
+  else {
+    return static_cast<To>(from.get());
+  }
+}
+
+// 自相对指针：保存目标地址相对自身地址的偏移，数据整体移动（mmap、共享内存）后仍然有效
+template <typename T>
+class offset_ptr
 {
+public:
+  using element_type = T;
+
+  offset_ptr() noexcept = default;
+  offset_ptr(std::nullptr_t) noexcept {}
+  explicit offset_ptr(T* ptr) noexcept { reset(ptr); }
+
+  // 复制时按新地址重新计算偏移
+  offset_ptr(const offset_ptr& other) noexcept { reset(other.get()); }
+
+  offset_ptr& operator=(const offset_ptr& other) noexcept
+  {
+    reset(other.get());
+    return *this;
+  }
+
+  T* get() const noexcept
+  {
+    if (offset_ == null_offset) {
+      return nullptr;
+    }
+    return reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(this) +
+                                static_cast<std::uintptr_t>(offset_));
+  }
+
+  void reset(T* ptr) noexcept
+  {
+    if (!ptr) {
+      offset_ = null_offset;
+      return;
+    }
+    offset_ = static_cast<std::ptrdiff_t>(reinterpret_cast<std::uintptr_t>(ptr) -
+                                          reinterpret_cast<std::uintptr_t>(this));
+  }
+
+  std::ptrdiff_t offset() const noexcept { return offset_; }
+
+  T& operator*() const noexcept { return *get(); }
+  T* operator->() const noexcept { return get(); }
+  explicit operator bool() const noexcept { return offset_ != null_offset; }
+
+  friend bool operator==(const offset_ptr& lhs, const offset_ptr& rhs) noexcept
+  {
+    return lhs.get() == rhs.get();
+  }
+  friend bool operator!=(const offset_ptr& lhs, const offset_ptr& rhs) noexcept
+  {
+    return lhs.get() != rhs.get();
+  }
+
+private:
+  // 偏移1不可能指向一个对象的起始地址，用作空指针
+  static constexpr std::ptrdiff_t null_offset = 1;
+
+  std::ptrdiff_t offset_ = null_offset;
 };
-struct standard_conversion_tag
+
+// 自相对指针特征：对应的裸指针类型
+template <typename P>
+struct offset_pointer_traits
 {
+  static constexpr bool value = false;
+  using pointer = P;
+
+  static pointer unwrap(P from) noexcept { return from; }
+  static P wrap(pointer ptr) noexcept { return ptr; }
 };
-struct reinterpret_cast_tag
+
+template <typename T>
+struct offset_pointer_traits<offset_ptr<T>>
 {
+  static constexpr bool value = true;
+  using pointer = T*;
+
+  static pointer unwrap(const offset_ptr<T>& from) noexcept
+  {
+    return from.get();
+  }
+  static offset_ptr<T> wrap(pointer ptr) noexcept { return offset_ptr<T>(ptr); }
 };
-struct invalid_cast_tag
+
+// 至少一端是offset_ptr，另一端是指针或offset_ptr
+template <typename To, typename From>
+constexpr bool is_offset_pointer_conversion() noexcept
+{
+  using to_traits = offset_pointer_traits<std::remove_cv_t<To>>;
+  using from_traits = offset_pointer_traits<std::remove_cv_t<From>>;
+  return (to_traits::value || from_traits::value) &&
+         std::is_pointer<typename to_traits::pointer>::value &&
+         std::is_pointer<typename from_traits::pointer>::value;
+}
+
+// 半精度浮点：IEEE binary16 与 bfloat16，按位存储
+struct float16
 {
+  std::uint16_t bits;
+
+  static constexpr float16 from_bits(std::uint16_t bits) noexcept
+  {
+    return float16{bits};
+  }
 };
 
-// 
-template <typename T>
-struct remove_cv_ptr
+struct bfloat16
 {
-  using type = std::remove_cv_t<std::remove_pointer_t<T>>;
+  std::uint16_t bits;
+
+  static constexpr bfloat16 from_bits(std::uint16_t bits) noexcept
+  {
+    return bfloat16{bits};
+  }
 };
 
-template <typename T>
-using remove_cv_ptr_t = typename remove_cv_ptr<T>::type;
+inline std::uint32_t float_to_bits(float value) noexcept
+{
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
 
-// 麯
-template <typename To, typename From>
-constexpr bool is_up_cast_impl()
+inline float float_from_bits(std::uint32_t bits) noexcept
 {
-  return std::is_pointer<To>::value && std::is_pointer<From>::value &&
-         std::is_base_of<remove_cv_ptr_t<To>, remove_cv_ptr_t<From>>::value;
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
 }
 
-template <typename To, typename From>
-constexpr bool is_down_cast_impl()
+// binary16 -> float，总是精确
+inline float float16_bits_to_float(std::uint16_t half) noexcept
 {
-  return std::is_pointer<To>::value && std::is_pointer<From>::value &&
-         std::is_base_of<remove_cv_ptr_t<From>, remove_cv_ptr_t<To>>::value;
+  const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+  const std::uint32_t exponent = (half >> 10) & 0x1fu;
+  std::uint32_t mantissa = half & 0x3ffu;
+  if (exponent == 0x1fu) {  // 无穷大或NaN（NaN按硬件行为置为静默）
+    return float_from_bits(sign | 0x7f800000u | (mantissa << 13) |
+                           (mantissa ? 0x400000u : 0u));
+  }
+  if (exponent != 0) {
+    return float_from_bits(sign | ((exponent + 112) << 23) | (mantissa << 13));
+  }
+  if (mantissa == 0) {
+    return float_from_bits(sign);
+  }
+  // 非规格化数：规格化后重新计算指数
+  std::uint32_t biased = 113;
+  while (!(mantissa & 0x400u)) {
+    mantissa <<= 1;
+    --biased;
+  }
+  return float_from_bits(sign | (biased << 23) | ((mantissa & 0x3ffu) << 13));
 }
 
-// ݹǩַ
-template <typename To, typename From, typename Policy, int Step = 0>
-struct get_cast_tag
+// float -> binary16，就近舍入到偶数，NaN保持静默并保留高位载荷
+inline std::uint16_t float_to_float16_bits(float value) noexcept
 {
-  using type = typename get_cast_tag<To, From, Policy, Step + 1>::type;
-};
+  const std::uint32_t bits = float_to_bits(value);
+  const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+  const std::uint32_t magnitude = bits & 0x7fffffffu;
+  if (magnitude > 0x7f800000u) {
+    return sign | 0x7e00u | ((magnitude >> 13) & 0x3ffu);
+  }
+  if (magnitude >= 0x477ff000u) {  // 不小于65520时舍入为无穷大
+    return sign | 0x7c00u;
+  }
+  if (magnitude >= 0x38800000u) {  // 规格化数
+    std::uint32_t rebiased = magnitude - 0x38000000u;
+    rebiased += 0xfffu + ((rebiased >> 13) & 1u);
+    return static_cast<std::uint16_t>(sign | (rebiased >> 13));
+  }
+  if (magnitude <= 0x33000000u) {  // 不大于2^-25时舍入为零
+    return sign;
+  }
+  // 非规格化数
+  const unsigned shift = 126u - (magnitude >> 23);
+  const std::uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+  std::uint32_t result = mantissa >> shift;
+  const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+  const std::uint32_t halfway = 1u << (shift - 1);
+  if (remainder > halfway || (remainder == halfway && (result & 1u))) {
+    ++result;
+  }
+  return static_cast<std::uint16_t>(sign | result);
+}
 
-// Step 0: ͬ
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 0>
+inline float bfloat16_bits_to_float(std::uint16_t half) noexcept
 {
-  using type = typename std::conditional<
-      std::is_same<To, From>::value, same_type_tag,
-      typename get_cast_tag<To, From, Policy, 1>::type>::type;
+  return float_from_bits(static_cast<std::uint32_t>(half) << 16);
+}
+
+// float -> bfloat16，就近舍入到偶数
+inline std::uint16_t float_to_bfloat16_bits(float value) noexcept
+{
+  std::uint32_t bits = float_to_bits(value);
+  if ((bits & 0x7fffffffu) > 0x7f800000u) {
+    return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+  }
+  bits += 0x7fffu + ((bits >> 16) & 1u);
+  return static_cast<std::uint16_t>(bits >> 16);
+}
+
+// double先按“向奇数舍入”缩到float，避免二次舍入误差
+inline float double_to_float_round_to_odd(double value) noexcept
+{
+  float result = static_cast<float>(value);
+  if (static_cast<double>(result) != value && value == value) {
+    std::uint32_t bits = float_to_bits(result);
+    if (std::abs(static_cast<double>(result)) > std::abs(value)) {
+      --bits;
+    }
+    result = float_from_bits(bits | 1u);
+  }
+  return result;
+}
+
+// 超过53位的整数转double本身就会舍入一次：先截断到53位有效位，
+// 丢弃的低位并入最低位（向奇数舍入），保证后续只在最终精度舍入一次
+template <typename Integer>
+double integer_to_double_round_to_odd(Integer value) noexcept
+{
+  constexpr int double_digits = std::numeric_limits<double>::digits;
+  if constexpr (std::numeric_limits<Integer>::digits <= double_digits) {
+    return static_cast<double>(value);
+  }
+  else {
+    using magnitude_type = std::make_unsigned_t<Integer>;
+    bool negative = false;
+    magnitude_type magnitude = static_cast<magnitude_type>(value);
+    if constexpr (std::is_signed_v<Integer>) {
+      negative = value < 0;
+      if (negative) {
+        magnitude = magnitude_type(0) - magnitude;
+      }
+    }
+    int shift = 0;
+    while ((magnitude >> shift) >> double_digits != 0) {
+      ++shift;
+    }
+    if (shift != 0) {
+      const magnitude_type dropped =
+          magnitude & ((magnitude_type(1) << shift) - 1);
+      magnitude = (magnitude >> shift) | magnitude_type(dropped != 0);
+    }
+    const double result = std::ldexp(static_cast<double>(magnitude), shift);
+    return negative ? -result : result;
+  }
+}
+
+// 半精度类型特征
+template <typename T>
+struct half_precision_traits
+{
+  static constexpr bool value = false;
 };
-// Step 1: ȥconstת
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 1>
+
+template <>
+struct half_precision_traits<float16>
 {
-private:
-  static constexpr bool is_same_underlying =
-      std::is_same<remove_cv_ptr_t<To>, remove_cv_ptr_t<From>>::value;
-  static constexpr bool is_const_removal =
-      is_same_underlying && !std::is_same<To, From>::value &&
-      !std::is_const<remove_cv_ptr_t<To>>::value &&
-      std::is_const<remove_cv_ptr_t<From>>::value;
+  static constexpr bool value = true;
 
-public:
-  using type = typename std::conditional<
-      is_const_removal && Policy::allow_const_removal, const_removal_tag,
-      typename get_cast_tag<To, From, Policy, 2>::type>::type;
+  static float to_float(float16 from) noexcept
+  {
+#if defined(AUTO_CAST_X86_SIMD) && defined(__F16C__)
+    return _cvtsh_ss(from.bits);
+#else
+    return float16_bits_to_float(from.bits);
+#endif
+  }
+  static float16 from_float(float from) noexcept
+  {
+#if defined(AUTO_CAST_X86_SIMD) && defined(__F16C__)
+    return float16{static_cast<std::uint16_t>(
+        _cvtss_sh(from, _MM_FROUND_TO_NEAREST_INT))};
+#else
+    return float16{float_to_float16_bits(from)};
+#endif
+  }
 };
-// Step 2: ת
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 2>
+
+template <>
+struct half_precision_traits<bfloat16>
 {
-  using type =
-      std::conditional_t<is_up_cast_impl<To, From>(), up_cast_tag,
-                         typename get_cast_tag<To, From, Policy, 3>::type>;
+  static constexpr bool value = true;
+
+  static float to_float(bfloat16 from) noexcept
+  {
+    return bfloat16_bits_to_float(from.bits);
+  }
+  static bfloat16 from_float(float from) noexcept
+  {
+    return bfloat16{float_to_bfloat16_bits(from)};
+  }
 };
 
-// Step 3: ת̬
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 3>
+#ifdef __FLT16_MANT_DIG__
+// 编译器提供的_Float16与float16格式相同，走同一套转换避免依赖编译器行为
+template <>
+struct half_precision_traits<_Float16>
 {
-  using type = typename std::conditional<
-      is_down_cast_impl<To, From>() &&
-          std::is_polymorphic<remove_cv_ptr_t<From>>::value,
-      down_cast_polymorphic_tag,
-      typename get_cast_tag<To, From, Policy, 4>::type>::type;
+  static constexpr bool value = true;
+
+  static float to_float(_Float16 from) noexcept
+  {
+    float16 half;
+    std::memcpy(&half, &from, sizeof(half));
+    return half_precision_traits<float16>::to_float(half);
+  }
+  static _Float16 from_float(float from) noexcept
+  {
+    const float16 bits = half_precision_traits<float16>::from_float(from);
+    _Float16 result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+};
+#endif
+
+// 半精度与算术类型（或另一种半精度类型）之间的转换
+template <typename To, typename From>
+constexpr bool is_half_precision_conversion() noexcept
+{
+  using to_traits = half_precision_traits<std::remove_cv_t<To>>;
+  using from_traits = half_precision_traits<std::remove_cv_t<From>>;
+  return !std::is_same<std::remove_cv_t<To>, std::remove_cv_t<From>>::value &&
+         (to_traits::value || from_traits::value) &&
+         (to_traits::value || std::is_arithmetic<To>::value) &&
+         (from_traits::value || std::is_arithmetic<From>::value);
+}
+
+template <typename To, typename From>
+To half_precision_cast(From from) noexcept
+{
+  using to_traits = half_precision_traits<std::remove_cv_t<To>>;
+  using from_traits = half_precision_traits<std::remove_cv_t<From>>;
+  if constexpr (from_traits::value && to_traits::value) {
+    return to_traits::from_float(from_traits::to_float(from));
+  }
+  else if constexpr (from_traits::value) {
+    return static_cast<To>(from_traits::to_float(from));
+  }
+  else if constexpr (std::is_same<std::remove_cv_t<From>, float>::value) {
+    return to_traits::from_float(from);
+  }
+  else if constexpr (std::is_integral<std::remove_cv_t<From>>::value) {
+    return to_traits::from_float(
+        double_to_float_round_to_odd(integer_to_double_round_to_odd(from)));
+  }
+  else {
+    return to_traits::from_float(
+        double_to_float_round_to_odd(static_cast<double>(from)));
+  }
+}
+
+// 不拥有可调用对象的函数引用：只保存对象地址和调用入口，不分配内存
+// 被引用的对象必须比function_ref活得久
+template <typename Signature>
+class function_ref;
+
+template <typename R, typename... Args>
+class function_ref<R(Args...)>
+{
+public:
+  function_ref(R (*function)(Args...)) noexcept : invoke_(&invoke_function)
+  {
+    target_.function = function;
+  }
+
+  template <typename F,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::remove_cv_t<std::remove_reference_t<F>>,
+                                function_ref> &&
+                !std::is_pointer_v<std::decay_t<F>> &&
+                std::is_invocable_r_v<R, F&, Args...>>>
+  function_ref(F&& callable) noexcept
+      : invoke_(&invoke_object<std::remove_reference_t<F>>)
+  {
+    target_.object = std::addressof(callable);
+  }
+
+  R operator()(Args... args) const
+  {
+    return invoke_(target_, std::forward<Args>(args)...);
+  }
+
+private:
+  union target
+  {
+    const void* object;
+    R (*function)(Args...);
+  };
+
+  static R invoke_function(target target, Args... args)
+  {
+    return target.function(std::forward<Args>(args)...);
+  }
+
+  template <typename F>
+  static R invoke_object(target target, Args... args)
+  {
+    F* callable = static_cast<F*>(const_cast<void*>(target.object));
+    if constexpr (std::is_void_v<R>) {
+      (*callable)(std::forward<Args>(args)...);
+    }
+    else {
+      return (*callable)(std::forward<Args>(args)...);
+    }
+  }
+
+  target target_;
+  R (*invoke_)(target, Args...);
+};
+
+template <typename T>
+struct is_function_ref : std::false_type
+{
+};
+
+template <typename Signature>
+struct is_function_ref<function_ref<Signature>> : std::true_type
+{
+};
+
+// 可调用对象的转换：可调用对象转函数指针，函数指针转function_ref
+template <typename To, typename From>
+constexpr bool is_callable_conversion() noexcept
+{
+  if constexpr (std::is_pointer_v<To> &&
+                std::is_function_v<std::remove_pointer_t<To>>) {
+    return std::is_class_v<std::remove_cv_t<From>>;
+  }
+  else {
+    return is_function_ref<std::remove_cv_t<To>>::value &&
+           !std::is_same_v<std::remove_cv_t<To>, std::remove_cv_t<From>>;
+  }
+}
+
+// 只有无捕获的lambda能转为函数指针；function_ref按值只能接收函数指针，
+// 类对象要以左值传给auto_cast（From为左值引用），否则会引用参数的副本
+template <typename To, typename From>
+constexpr bool is_valid_callable_conversion() noexcept
+{
+  if constexpr (std::is_pointer_v<To>) {
+    return std::is_convertible_v<From, To>;
+  }
+  else if constexpr (std::is_lvalue_reference_v<From>) {
+    return std::is_class_v<std::remove_reference_t<From>> &&
+           std::is_constructible_v<To, From>;
+  }
+  else {
+    return std::is_pointer_v<From> &&
+           std::is_function_v<std::remove_pointer_t<From>> &&
+           std::is_constructible_v<To, From>;
+  }
+}
+
+template <typename To, typename From>
+To callable_cast(From from) noexcept
+{
+  if constexpr (is_valid_callable_conversion<To, From>()) {
+    return static_cast<To>(from);
+  }
+  else if constexpr (std::is_pointer_v<To>) {
+    static_assert(std::is_convertible_v<From, To>,
+                  "auto_cast<>: only captureless callables convert to "
+                  "function pointers; use function_ref<> for callables with "
+                  "captures");
+    return nullptr;
+  }
+  else {
+    static_assert(!std::is_class_v<std::remove_cv_t<From>>,
+                  "auto_cast<>: function_ref<> would refer to a copy of the "
+                  "callable; pass the callable to auto_cast as an lvalue");
+    static_assert(std::is_constructible_v<To, From>,
+                  "auto_cast<>: function signature does not match "
+                  "function_ref<>");
+    return To(from);
+  }
+}
+
+// 聚合体字段反射：用能转换为任意类型的占位参数探测字段个数，再用结构化绑定取出字段
+// 只支持没有基类、没有数组成员、最多16个字段的聚合体
+struct any_aggregate_field
+{
+  template <typename T>
+  operator T&() const noexcept;
+};
+
+template <typename T, typename Indices, typename = void>
+struct is_aggregate_initializable : std::false_type
+{
+};
+
+template <typename T, std::size_t... I>
+struct is_aggregate_initializable<
+    T, std::index_sequence<I...>,
+    std::void_t<decltype(T{(void(I), any_aggregate_field{})...})>>
+    : std::true_type
+{
+};
+
+template <typename T, std::size_t N = 16>
+constexpr std::size_t aggregate_field_count() noexcept
+{
+  if constexpr (N == 0) {
+    return 0;
+  }
+  else if constexpr (is_aggregate_initializable<
+                         T, std::make_index_sequence<N>>::value) {
+    return N;
+  }
+  else {
+    return aggregate_field_count<T, N - 1>();
+  }
+}
+
+// 返回字段引用组成的tuple
+template <typename T>
+constexpr auto aggregate_tie(T& value) noexcept
+{
+  constexpr std::size_t count = aggregate_field_count<std::remove_const_t<T>>();
+  static_assert(std::is_aggregate_v<std::remove_const_t<T>> && count > 0,
+                "aggregate_tie<>: type must be an aggregate with 1 to 16 fields");
+  if constexpr (count == 1) {
+    auto& [f0] = value;
+    return std::tie(f0);
+  }
+  else if constexpr (count == 2) {
+    auto& [f0, f1] = value;
+    return std::tie(f0, f1);
+  }
+  else if constexpr (count == 3) {
+    auto& [f0, f1, f2] = value;
+    return std::tie(f0, f1, f2);
+  }
+  else if constexpr (count == 4) {
+    auto& [f0, f1, f2, f3] = value;
+    return std::tie(f0, f1, f2, f3);
+  }
+  else if constexpr (count == 5) {
+    auto& [f0, f1, f2, f3, f4] = value;
+    return std::tie(f0, f1, f2, f3, f4);
+  }
+  else if constexpr (count == 6) {
+    auto& [f0, f1, f2, f3, f4, f5] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5);
+  }
+  else if constexpr (count == 7) {
+    auto& [f0, f1, f2, f3, f4, f5, f6] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6);
+  }
+  else if constexpr (count == 8) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+  }
+  else if constexpr (count == 9) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+  }
+  else if constexpr (count == 10) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+  }
+  else if constexpr (count == 11) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+  }
+  else if constexpr (count == 12) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+  }
+  else if constexpr (count == 13) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+  }
+  else if constexpr (count == 14) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12,
+                    f13);
+  }
+  else if constexpr (count == 15) {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] =
+        value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12,
+                    f13, f14);
+  }
+  else {
+    auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14,
+           f15] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12,
+                    f13, f14, f15);
+  }
+}
+
+template <typename Tuple>
+struct remove_tuple_references;
+
+template <typename... T>
+struct remove_tuple_references<std::tuple<T...>>
+{
+  using type = std::tuple<std::remove_cv_t<std::remove_reference_t<T>>...>;
+};
+
+// 聚合体各字段的类型
+template <typename T>
+using aggregate_field_types_t = typename remove_tuple_references<
+    decltype(aggregate_tie(std::declval<T&>()))>::type;
+
+#if __cplusplus >= 202002
+template <typename To, typename From, is_cast_policy Policy>
+class auto_cast_impl;
+#elif CPP_11
+template <typename To, typename From, typename Policy>
+struct auto_cast_impl;
+#endif
+
+// 聚合体之间的逐字段转换，需要显式启用：特化aggregate_field_mapping<To, From>，
+// 继承positional_field_mapping按位置对应，或继承field_mapping<I...>，To的第k个字段取From的第I_k个字段
+template <typename To, typename From>
+struct aggregate_field_mapping
+{
+  static constexpr bool enabled = false;
+};
+
+struct positional_field_mapping
+{
+  static constexpr bool enabled = true;
+};
+
+template <std::size_t... FromIndex>
+struct field_mapping
+{
+  static constexpr bool enabled = true;
+  static constexpr std::array<std::size_t, sizeof...(FromIndex)> indices{
+      {FromIndex...}};
+};
+
+template <typename To, typename From>
+constexpr bool is_aggregate_conversion() noexcept
+{
+  using to = std::remove_cv_t<To>;
+  using from = std::remove_cv_t<From>;
+  if constexpr (std::is_class_v<to> && std::is_class_v<from> &&
+                !std::is_same_v<to, from>) {
+    return aggregate_field_mapping<to, from>::enabled;
+  }
+  else {
+    return false;
+  }
+}
+
+// 按标准布局规则推算的字段偏移；只有推算出的大小与sizeof一致时才使用，
+// 成员上的alignas、[[no_unique_address]]仍可能让实际偏移不同，使用前需要核对
+template <typename Fields>
+struct aggregate_layout;
+
+template <typename... Fields>
+struct aggregate_layout<std::tuple<Fields...>>
+{
+  static constexpr std::size_t count = sizeof...(Fields);
+  static constexpr std::array<std::size_t, count> sizes{{sizeof(Fields)...}};
+  static constexpr std::array<std::size_t, count> offsets = [] {
+    constexpr std::size_t alignments[] = {alignof(Fields)...};
+    std::array<std::size_t, count> result{};
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      offset = (offset + alignments[i] - 1) / alignments[i] * alignments[i];
+      result[i] = offset;
+      offset += sizes[i];
+    }
+    return result;
+  }();
+  static constexpr std::size_t size = [] {
+    constexpr std::size_t alignment = std::max({alignof(Fields)...});
+    const std::size_t end = offsets[count - 1] + sizes[count - 1];
+    return (end + alignment - 1) / alignment * alignment;
+  }();
+};
+
+template <typename T>
+constexpr bool is_aggregate_layout_known() noexcept
+{
+  return std::is_standard_layout_v<T> &&
+         aggregate_layout<aggregate_field_types_t<T>>::size == sizeof(T);
+}
+
+// To的第i个字段对应的From字段
+template <typename To, typename From>
+constexpr std::size_t aggregate_source_index(std::size_t i) noexcept
+{
+  using mapping = aggregate_field_mapping<To, From>;
+  if constexpr (std::is_base_of_v<positional_field_mapping, mapping>) {
+    return i;
+  }
+  else {
+    return mapping::indices[i];
+  }
+}
+
+template <typename To, typename From>
+constexpr bool is_aggregate_mapping_valid() noexcept
+{
+  using mapping = aggregate_field_mapping<To, From>;
+  constexpr std::size_t to_count =
+      std::tuple_size_v<aggregate_field_types_t<To>>;
+  constexpr std::size_t from_count =
+      std::tuple_size_v<aggregate_field_types_t<From>>;
+  if constexpr (std::is_base_of_v<positional_field_mapping, mapping>) {
+    return from_count == to_count;
+  }
+  else {
+    if (mapping::indices.size() != to_count) {
+      return false;
+    }
+    for (std::size_t index : mapping::indices) {
+      if (index >= from_count) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+// 编译时的转换计划：字段对应关系，以及哪些相邻字段可以合并为一次memcpy
+template <typename To, typename From>
+struct aggregate_conversion_plan
+{
+  static_assert(is_aggregate_mapping_valid<To, From>(),
+                "auto_cast<>: aggregate field mapping does not match the "
+                "number of fields of the source and target types");
+
+  using to_fields = aggregate_field_types_t<To>;
+  using from_fields = aggregate_field_types_t<From>;
+  using to_layout = aggregate_layout<to_fields>;
+  using from_layout = aggregate_layout<from_fields>;
+  static constexpr std::size_t field_count = std::tuple_size_v<to_fields>;
+
+  static constexpr std::size_t source_index(std::size_t i) noexcept
+  {
+    return aggregate_source_index<To, From>(i);
+  }
+
+  template <std::size_t I>
+  using to_field = std::tuple_element_t<I, to_fields>;
+
+  template <std::size_t I>
+  using from_field = std::tuple_element_t<aggregate_source_index<To, From>(I),
+                                          from_fields>;
+
+  static constexpr bool layouts_known =
+      is_aggregate_layout_known<To>() && is_aggregate_layout_known<From>();
+
+  // 同类型的可平凡复制字段可以按字节复制
+  template <std::size_t I>
+  static constexpr bool is_bitwise() noexcept
+  {
+    return layouts_known && std::is_same_v<to_field<I>, from_field<I>> &&
+           std::is_trivially_copyable_v<to_field<I>>;
+  }
+
+  // 第I个字段能与前一个字段合并：两边都紧跟在前一个字段之后且间距相同
+  template <std::size_t I>
+  static constexpr bool joins_previous() noexcept
+  {
+    if constexpr (I == 0) {
+      return false;
+    }
+    else {
+      return is_bitwise<I - 1>() && is_bitwise<I>() &&
+             source_index(I) == source_index(I - 1) + 1 &&
+             to_layout::offsets[I] - to_layout::offsets[I - 1] ==
+                 from_layout::offsets[source_index(I)] -
+                     from_layout::offsets[source_index(I - 1)];
+    }
+  }
+
+  // 从第I个字段开始的合并段的最后一个字段
+  template <std::size_t I>
+  static constexpr std::size_t run_end() noexcept
+  {
+    if constexpr (I + 1 < field_count) {
+      if constexpr (joins_previous<I + 1>()) {
+        return run_end<I + 1>();
+      }
+      else {
+        return I;
+      }
+    }
+    else {
+      return I;
+    }
+  }
+
+  // 整个记录就是一次memcpy
+  static constexpr bool is_bitwise_copy() noexcept
+  {
+    if constexpr (is_bitwise<0>() && run_end<0>() == field_count - 1) {
+      return sizeof(To) == sizeof(From) && source_index(0) == 0 &&
+             std::is_trivially_copyable_v<To> &&
+             std::is_trivially_copyable_v<From>;
+    }
+    else {
+      return false;
+    }
+  }
+
+  // 是否有字段要按推算的偏移做memcpy
+  static constexpr bool uses_layout() noexcept
+  {
+    return layouts_known &&
+           has_bitwise_field(std::make_index_sequence<field_count>{});
+  }
+
+  // 推算的偏移与真实字段地址一致：每对类型只在第一次转换时核对一次，
+  // 不一致时（成员alignas等）所有构建模式都退回逐字段转换
+  static bool layout_matches(const To& to, const From& from) noexcept
+  {
+    static const bool matches =
+        offsets_match<to_layout>(to, std::make_index_sequence<field_count>{}) &&
+        offsets_match<from_layout>(
+            from, std::make_index_sequence<std::tuple_size_v<from_fields>>{});
+    return matches;
+  }
+
+private:
+  template <std::size_t... I>
+  static constexpr bool has_bitwise_field(std::index_sequence<I...>) noexcept
+  {
+    return (is_bitwise<I>() || ...);
+  }
+
+  template <typename Layout, typename T, std::size_t... I>
+  static bool offsets_match(const T& value, std::index_sequence<I...>) noexcept
+  {
+    const auto fields = aggregate_tie(value);
+    const auto* base = reinterpret_cast<const unsigned char*>(&value);
+    return ((reinterpret_cast<const unsigned char*>(&std::get<I>(fields)) ==
+             base + Layout::offsets[I]) &&
+            ...);
+  }
+};
+
+// Fused为false时不使用推算的偏移，每个字段都单独转换
+template <typename To, typename From, typename Policy, bool Fused,
+          std::size_t I>
+void aggregate_cast_field(const From& from, To& to)
+{
+  using plan = aggregate_conversion_plan<To, From>;
+  constexpr std::size_t source = plan::source_index(I);
+  if constexpr (Fused && plan::template joins_previous<I>()) {
+    // 已由前面的memcpy复制
+  }
+  else if constexpr (Fused && plan::template is_bitwise<I>()) {
+    constexpr std::size_t last = plan::template run_end<I>();
+    constexpr std::size_t to_offset = plan::to_layout::offsets[I];
+    constexpr std::size_t from_offset = plan::from_layout::offsets[source];
+    constexpr std::size_t bytes =
+        plan::to_layout::offsets[last] + plan::to_layout::sizes[last] -
+        to_offset;
+    std::memcpy(reinterpret_cast<unsigned char*>(&to) + to_offset,
+                reinterpret_cast<const unsigned char*>(&from) + from_offset,
+                bytes);
+  }
+  else {
+    std::get<I>(aggregate_tie(to)) =
+        auto_cast_impl<typename plan::template to_field<I>,
+                       typename plan::template from_field<I>,
+                       Policy>::cast(std::get<source>(aggregate_tie(from)));
+  }
+}
+
+template <typename To, typename From, typename Policy, bool Fused,
+          std::size_t... I>
+void aggregate_cast_fields(const From& from, To& to, std::index_sequence<I...>)
+{
+  (aggregate_cast_field<To, From, Policy, Fused, I>(from, to), ...);
+}
+
+// 逐字段按策略auto_cast写入已有记录，相邻的同类型字段合并为memcpy
+template <typename Policy, typename To, typename From>
+void aggregate_cast_into(const From& from, To& to)
+{
+  using plan = aggregate_conversion_plan<To, From>;
+  using indices = std::make_index_sequence<plan::field_count>;
+  if constexpr (plan::uses_layout()) {
+    if (plan::layout_matches(to, from)) {
+      if constexpr (plan::is_bitwise_copy()) {
+        std::memcpy(&to, &from, sizeof(To));
+      }
+      else {
+        aggregate_cast_fields<To, From, Policy, true>(from, to, indices{});
+      }
+      return;
+    }
+  }
+  aggregate_cast_fields<To, From, Policy, false>(from, to, indices{});
+}
+
+template <typename To, typename Policy, typename From>
+To aggregate_cast(const From& from)
+{
+  // 每个字段都会被写入，无需先值初始化
+  std::remove_cv_t<To> result;
+  aggregate_cast_into<Policy>(from, result);
+  return result;
+}
+
+// Unicode文本转码：UTF-8 / UTF-16 / UTF-32的string_view转为另一种编码的字符串
+enum class unicode_encoding
+{
+  utf8,
+  utf16,
+  utf32
+};
+
+// 编码单元类型对应的编码，wchar_t按宽度视为UTF-16或UTF-32
+template <typename Char>
+struct unicode_char_traits
+{
+  static constexpr bool value = false;
+};
+
+template <>
+struct unicode_char_traits<char>
+{
+  static constexpr bool value = true;
+  static constexpr unicode_encoding encoding = unicode_encoding::utf8;
+};
+
+#ifdef __cpp_char8_t
+template <>
+struct unicode_char_traits<char8_t>
+{
+  static constexpr bool value = true;
+  static constexpr unicode_encoding encoding = unicode_encoding::utf8;
+};
+#endif
+
+template <>
+struct unicode_char_traits<char16_t>
+{
+  static constexpr bool value = true;
+  static constexpr unicode_encoding encoding = unicode_encoding::utf16;
+};
+
+template <>
+struct unicode_char_traits<char32_t>
+{
+  static constexpr bool value = true;
+  static constexpr unicode_encoding encoding = unicode_encoding::utf32;
+};
+
+template <>
+struct unicode_char_traits<wchar_t>
+{
+  static constexpr bool value = true;
+  static constexpr unicode_encoding encoding =
+      sizeof(wchar_t) == 2 ? unicode_encoding::utf16 : unicode_encoding::utf32;
+};
+
+template <typename T>
+struct unicode_string_view_traits
+{
+  static constexpr bool value = false;
+};
+
+template <typename Char>
+struct unicode_string_view_traits<std::basic_string_view<Char>>
+{
+  static constexpr bool value = unicode_char_traits<Char>::value;
+  using char_type = Char;
+};
+
+template <typename T>
+struct unicode_string_traits
+{
+  static constexpr bool value = false;
+};
+
+template <typename Char, typename Allocator>
+struct unicode_string_traits<
+    std::basic_string<Char, std::char_traits<Char>, Allocator>>
+{
+  static constexpr bool value = unicode_char_traits<Char>::value;
+  using char_type = Char;
+};
+
+// string_view转为编码单元类型不同的字符串；相同类型之间仍是标准转换
+template <typename To, typename From>
+constexpr bool is_unicode_conversion() noexcept
+{
+  using to = std::remove_cv_t<To>;
+  using from = std::remove_cv_t<From>;
+  if constexpr (unicode_string_traits<to>::value &&
+                unicode_string_view_traits<from>::value) {
+    using to_char = typename unicode_string_traits<to>::char_type;
+    using from_char = typename unicode_string_view_traits<from>::char_type;
+    return !std::is_same_v<to_char, from_char>;
+  }
+  else {
+    return false;
+  }
+}
+
+// 输入不是合法的UTF编码；position为第一个非法序列的起始编码单元
+class unicode_error : public std::range_error
+{
+public:
+  explicit unicode_error(std::size_t position)
+      : std::range_error("auto_cast<>: invalid Unicode input"),
+        position_(position)
+  {
+  }
+
+  std::size_t position() const noexcept { return position_; }
+
+private:
+  std::size_t position_;
+};
+
+static constexpr std::size_t unicode_valid = static_cast<std::size_t>(-1);
+static constexpr std::uint32_t unicode_invalid_code_point = 0xffffffffu;
+
+// 校验结果：目标编码单元数，以及第一个非法序列的位置（合法时为unicode_valid）
+struct unicode_measure
+{
+  std::size_t length;
+  std::size_t error_position;
+
+  bool valid() const noexcept { return error_position == unicode_valid; }
+};
+
+template <typename Char>
+constexpr std::uint32_t unicode_unit(Char c) noexcept
+{
+  return static_cast<std::uint32_t>(static_cast<std::make_unsigned_t<Char>>(c));
+}
+
+template <unicode_encoding Encoding>
+struct unicode_codec;
+
+template <>
+struct unicode_codec<unicode_encoding::utf8>
+{
+  // 拒绝过长编码、代理项、超过U+10FFFF的码点和截断的序列
+  template <typename Char>
+  static std::uint32_t decode(const Char* from, std::size_t count,
+                              std::size_t& i) noexcept
+  {
+    const std::uint32_t lead = unicode_unit(from[i]);
+    if (lead < 0x80u) {
+      ++i;
+      return lead;
+    }
+    std::size_t length;
+    std::uint32_t code_point;
+    std::uint32_t minimum;
+    if (lead >= 0xc2u && lead <= 0xdfu) {
+      length = 2;
+      code_point = lead & 0x1fu;
+      minimum = 0x80u;
+    }
+    else if ((lead & 0xf0u) == 0xe0u) {
+      length = 3;
+      code_point = lead & 0x0fu;
+      minimum = 0x800u;
+    }
+    else if (lead >= 0xf0u && lead <= 0xf4u) {
+      length = 4;
+      code_point = lead & 0x07u;
+      minimum = 0x10000u;
+    }
+    else {
+      return unicode_invalid_code_point;
+    }
+    if (count - i < length) {
+      return unicode_invalid_code_point;
+    }
+    for (std::size_t k = 1; k < length; ++k) {
+      const std::uint32_t continuation = unicode_unit(from[i + k]);
+      if ((continuation & 0xc0u) != 0x80u) {
+        return unicode_invalid_code_point;
+      }
+      code_point = (code_point << 6) | (continuation & 0x3fu);
+    }
+    if (code_point < minimum || code_point > 0x10ffffu ||
+        (code_point >= 0xd800u && code_point <= 0xdfffu)) {
+      return unicode_invalid_code_point;
+    }
+    i += length;
+    return code_point;
+  }
+
+  // 输入已校验
+  template <typename Char>
+  static std::uint32_t decode_valid(const Char* from, std::size_t& i) noexcept
+  {
+    const std::uint32_t lead = unicode_unit(from[i]);
+    if (lead < 0x80u) {
+      ++i;
+      return lead;
+    }
+    const std::uint32_t second = unicode_unit(from[i + 1]) & 0x3fu;
+    if (lead < 0xe0u) {
+      i += 2;
+      return ((lead & 0x1fu) << 6) | second;
+    }
+    const std::uint32_t third = unicode_unit(from[i + 2]) & 0x3fu;
+    if (lead < 0xf0u) {
+      i += 3;
+      return ((lead & 0x0fu) << 12) | (second << 6) | third;
+    }
+    const std::uint32_t fourth = unicode_unit(from[i + 3]) & 0x3fu;
+    i += 4;
+    return ((lead & 0x07u) << 18) | (second << 12) | (third << 6) | fourth;
+  }
+
+  static std::size_t encoded_length(std::uint32_t code_point) noexcept
+  {
+    return code_point < 0x80u      ? 1
+           : code_point < 0x800u   ? 2
+           : code_point < 0x10000u ? 3
+                                   : 4;
+  }
+
+  template <typename Char>
+  static Char* encode(std::uint32_t code_point, Char* to) noexcept
+  {
+    if (code_point < 0x80u) {
+      *to++ = static_cast<Char>(code_point);
+    }
+    else if (code_point < 0x800u) {
+      *to++ = static_cast<Char>(0xc0u | (code_point >> 6));
+      *to++ = static_cast<Char>(0x80u | (code_point & 0x3fu));
+    }
+    else if (code_point < 0x10000u) {
+      *to++ = static_cast<Char>(0xe0u | (code_point >> 12));
+      *to++ = static_cast<Char>(0x80u | ((code_point >> 6) & 0x3fu));
+      *to++ = static_cast<Char>(0x80u | (code_point & 0x3fu));
+    }
+    else {
+      *to++ = static_cast<Char>(0xf0u | (code_point >> 18));
+      *to++ = static_cast<Char>(0x80u | ((code_point >> 12) & 0x3fu));
+      *to++ = static_cast<Char>(0x80u | ((code_point >> 6) & 0x3fu));
+      *to++ = static_cast<Char>(0x80u | (code_point & 0x3fu));
+    }
+    return to;
+  }
+};
+
+template <>
+struct unicode_codec<unicode_encoding::utf16>
+{
+  // 拒绝不成对的代理项
+  template <typename Char>
+  static std::uint32_t decode(const Char* from, std::size_t count,
+                              std::size_t& i) noexcept
+  {
+    const std::uint32_t unit = unicode_unit(from[i]);
+    if (unit < 0xd800u || unit > 0xdfffu) {
+      ++i;
+      return unit;
+    }
+    if (unit > 0xdbffu || count - i < 2) {
+      return unicode_invalid_code_point;
+    }
+    const std::uint32_t low = unicode_unit(from[i + 1]);
+    if (low < 0xdc00u || low > 0xdfffu) {
+      return unicode_invalid_code_point;
+    }
+    i += 2;
+    return 0x10000u + ((unit - 0xd800u) << 10) + (low - 0xdc00u);
+  }
+
+  template <typename Char>
+  static std::uint32_t decode_valid(const Char* from, std::size_t& i) noexcept
+  {
+    const std::uint32_t unit = unicode_unit(from[i]);
+    if (unit < 0xd800u || unit > 0xdfffu) {
+      ++i;
+      return unit;
+    }
+    const std::uint32_t low = unicode_unit(from[i + 1]);
+    i += 2;
+    return 0x10000u + ((unit - 0xd800u) << 10) + (low - 0xdc00u);
+  }
+
+  static std::size_t encoded_length(std::uint32_t code_point) noexcept
+  {
+    return code_point < 0x10000u ? 1 : 2;
+  }
+
+  template <typename Char>
+  static Char* encode(std::uint32_t code_point, Char* to) noexcept
+  {
+    if (code_point < 0x10000u) {
+      *to++ = static_cast<Char>(code_point);
+    }
+    else {
+      code_point -= 0x10000u;
+      *to++ = static_cast<Char>(0xd800u + (code_point >> 10));
+      *to++ = static_cast<Char>(0xdc00u + (code_point & 0x3ffu));
+    }
+    return to;
+  }
+};
+
+template <>
+struct unicode_codec<unicode_encoding::utf32>
+{
+  template <typename Char>
+  static std::uint32_t decode(const Char* from, std::size_t,
+                              std::size_t& i) noexcept
+  {
+    const std::uint32_t unit = unicode_unit(from[i]);
+    if (unit > 0x10ffffu || (unit >= 0xd800u && unit <= 0xdfffu)) {
+      return unicode_invalid_code_point;
+    }
+    ++i;
+    return unit;
+  }
+
+  template <typename Char>
+  static std::uint32_t decode_valid(const Char* from, std::size_t& i) noexcept
+  {
+    return unicode_unit(from[i++]);
+  }
+
+  static std::size_t encoded_length(std::uint32_t) noexcept { return 1; }
+
+  template <typename Char>
+  static Char* encode(std::uint32_t code_point, Char* to) noexcept
+  {
+    *to++ = static_cast<Char>(code_point);
+    return to;
+  }
+};
+
+// 各目标编码下的长度（编码单元数）
+struct unicode_lengths
+{
+  std::size_t utf8;
+  std::size_t utf16;
+  std::size_t utf32;
+};
+
+template <unicode_encoding Encoding>
+constexpr std::size_t unicode_length_for(
+    const unicode_lengths& lengths) noexcept
+{
+  return Encoding == unicode_encoding::utf8    ? lengths.utf8
+         : Encoding == unicode_encoding::utf16 ? lengths.utf16
+                                               : lengths.utf32;
+}
+
+// 从第i个编码单元起逐个码点校验，length累加目标编码单元数
+template <typename ToChar, typename FromChar>
+unicode_measure measure_unicode_from(const FromChar* from, std::size_t count,
+                                     std::size_t i, std::size_t length) noexcept
+{
+  using from_codec = unicode_codec<unicode_char_traits<FromChar>::encoding>;
+  using to_codec = unicode_codec<unicode_char_traits<ToChar>::encoding>;
+  while (i < count) {
+    const std::size_t start = i;
+    const std::uint32_t code_point = from_codec::decode(from, count, i);
+    if (code_point == unicode_invalid_code_point) {
+      return {length, start};
+    }
+    length += to_codec::encoded_length(code_point);
+  }
+  return {length, unicode_valid};
+}
+
+template <typename ToChar, typename FromChar>
+unicode_measure measure_unicode_portable(const FromChar* from,
+                                         std::size_t count) noexcept
+{
+  return measure_unicode_from<ToChar>(from, count, 0, 0);
+}
+
+// 输入已校验，从第i个编码单元起逐个码点转换
+template <typename ToChar, typename FromChar>
+ToChar* transcode_unicode_from(const FromChar* from, std::size_t count,
+                               std::size_t i, ToChar* to) noexcept
+{
+  using from_codec = unicode_codec<unicode_char_traits<FromChar>::encoding>;
+  using to_codec = unicode_codec<unicode_char_traits<ToChar>::encoding>;
+  while (i < count) {
+    to = to_codec::encode(from_codec::decode_valid(from, i), to);
+  }
+  return to;
+}
+
+template <typename ToChar, typename FromChar>
+void transcode_unicode_portable(const FromChar* from, std::size_t count,
+                                ToChar* to) noexcept
+{
+  transcode_unicode_from(from, count, 0, to);
+}
+
+#ifdef AUTO_CAST_X86_SIMD
+// UTF-8校验按Keiser与Lemire的查表法：由前一字节的高低半字节和当前字节的高半字节
+// 各查一张错误类别表，三者相与即为当前字节处的错误
+__attribute__((target("avx2"))) inline __m256i utf8_block_errors_avx2(
+    __m256i block, __m256i previous) noexcept
+{
+  constexpr char too_short = 1 << 0;
+  constexpr char too_long = 1 << 1;
+  constexpr char overlong_3 = 1 << 2;
+  constexpr char too_large = 1 << 3;
+  constexpr char surrogate = 1 << 4;
+  constexpr char overlong_2 = 1 << 5;
+  constexpr char too_large_1000 = 1 << 6;
+  constexpr char overlong_4 = 1 << 6;
+  constexpr char two_continuations = static_cast<char>(1 << 7);
+  constexpr char carry = too_short | too_long | two_continuations;
+
+  const __m256i byte_1_high_table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+      too_long, two_continuations, two_continuations, two_continuations,
+      two_continuations, too_short | overlong_2, too_short,
+      too_short | overlong_3 | surrogate,
+      too_short | too_large | too_large_1000 | overlong_4));
+  const __m256i byte_1_low_table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry,
+      carry, carry | too_large, carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000 | surrogate,
+      carry | too_large | too_large_1000, carry | too_large | too_large_1000));
+  const __m256i byte_2_high_table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      too_short, too_short, too_short, too_short, too_short, too_short,
+      too_short, too_short,
+      too_long | overlong_2 | two_continuations | overlong_3 | too_large_1000 |
+          overlong_4,
+      too_long | overlong_2 | two_continuations | overlong_3 | too_large,
+      too_long | overlong_2 | two_continuations | surrogate | too_large,
+      too_long | overlong_2 | two_continuations | surrogate | too_large,
+      too_short, too_short, too_short, too_short));
+
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i joined = _mm256_permute2x128_si256(previous, block, 0x21);
+  const __m256i previous_1 = _mm256_alignr_epi8(block, joined, 15);
+  const __m256i previous_2 = _mm256_alignr_epi8(block, joined, 14);
+  const __m256i previous_3 = _mm256_alignr_epi8(block, joined, 13);
+  const __m256i special = _mm256_and_si256(
+      _mm256_and_si256(
+          _mm256_shuffle_epi8(
+              byte_1_high_table,
+              _mm256_and_si256(_mm256_srli_epi16(previous_1, 4), nibble)),
+          _mm256_shuffle_epi8(byte_1_low_table,
+                              _mm256_and_si256(previous_1, nibble))),
+      _mm256_shuffle_epi8(
+          byte_2_high_table,
+          _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble)));
+  // 三字节和四字节序列的第三、四个字节必须是后续字节
+  const __m256i must_be_continuation = _mm256_and_si256(
+      _mm256_or_si256(_mm256_subs_epu8(previous_2, _mm256_set1_epi8(0x60)),
+                      _mm256_subs_epu8(previous_3, _mm256_set1_epi8(0x70))),
+      _mm256_set1_epi8(static_cast<char>(0x80)));
+  return _mm256_xor_si256(must_be_continuation, special);
+}
+
+// 只校验整块；返回已校验且落在序列边界上的编码单元数，剩余部分逐个码点处理
+template <typename FromChar>
+__attribute__((target("avx2"))) std::size_t validate_utf8_avx2(
+    const FromChar* from, std::size_t count, unicode_lengths& lengths) noexcept
+{
+  const auto* source = reinterpret_cast<const unsigned char*>(from);
+  const __m256i continuation_limit = _mm256_set1_epi8(-65);
+  const __m256i four_byte_lead = _mm256_set1_epi8(static_cast<char>(0xf0));
+  // 块末尾三个字节不小于这些值时，序列延续到下一块
+  const __m256i incomplete_limit = _mm256_setr_epi8(
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xf0 - 1),
+      static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+  __m256i previous = _mm256_setzero_si256();
+  __m256i incomplete = _mm256_setzero_si256();
+  std::size_t i = 0;
+  std::size_t leads = 0;
+  std::size_t four_byte_leads = 0;
+  for (; i + 32 <= count; i += 32) {
+    const __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+    if (_mm256_movemask_epi8(block) == 0) {
+      if (!_mm256_testz_si256(incomplete, incomplete)) {
+        break;
+      }
+      leads += 32;
+    }
+    else {
+      const __m256i errors = utf8_block_errors_avx2(block, previous);
+      if (!_mm256_testz_si256(errors, errors)) {
+        break;
+      }
+      // 后续字节为0x80到0xbf，按有符号比较不大于-65
+      leads += static_cast<std::size_t>(__builtin_popcount(
+          static_cast<unsigned>(_mm256_movemask_epi8(
+              _mm256_cmpgt_epi8(block, continuation_limit)))));
+      four_byte_leads += static_cast<std::size_t>(__builtin_popcount(
+          static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+              _mm256_max_epu8(block, four_byte_lead), block)))));
+    }
+    previous = block;
+    incomplete = _mm256_subs_epu8(block, incomplete_limit);
+  }
+  // 退回到跨越块边界的序列开头
+  for (std::size_t back = 1; back <= 3 && back <= i; ++back) {
+    const unsigned lead = source[i - back];
+    if (lead < 0x80u) {
+      break;
+    }
+    if (lead >= 0xc0u) {
+      const std::size_t length = lead >= 0xf0u ? 4 : lead >= 0xe0u ? 3 : 2;
+      if (length > back) {
+        i -= back;
+        --leads;
+        four_byte_leads -= length == 4;
+      }
+      break;
+    }
+  }
+  lengths = {i, leads + four_byte_leads, leads};
+  return i;
+}
+
+template <typename FromChar>
+__attribute__((target("avx2"))) std::size_t validate_utf16_avx2(
+    const FromChar* from, std::size_t count, unicode_lengths& lengths) noexcept
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i non_ascii = _mm256_set1_epi16(static_cast<short>(0xff80));
+  const __m256i wide = _mm256_set1_epi16(static_cast<short>(0xf800));
+  const __m256i surrogate_mask = _mm256_set1_epi16(static_cast<short>(0xfc00));
+  const __m256i high_surrogate = _mm256_set1_epi16(static_cast<short>(0xd800));
+  const __m256i low_surrogate = _mm256_set1_epi16(static_cast<short>(0xdc00));
+  std::size_t i = 0;
+  std::size_t utf8 = 0;
+  std::size_t low_count = 0;
+  // 上一块以高代理项结尾时为0b11（掩码中每个16位单元占2位）
+  unsigned carry = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+    const __m256i kind = _mm256_and_si256(block, surrogate_mask);
+    const auto highs = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi16(kind, high_surrogate)));
+    const auto lows = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi16(kind, low_surrogate)));
+    // 每个低代理项前面必须紧跟高代理项
+    if (lows != ((highs << 2) | carry)) {
+      break;
+    }
+    const auto ascii = static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi16(_mm256_and_si256(block, non_ascii), zero)));
+    const auto narrow = static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi16(_mm256_and_si256(block, wide), zero)));
+    // 1 + (>= 0x80) + (>= 0x800)，代理项各占2字节
+    const int extra_bytes = (64 - __builtin_popcount(ascii) -
+                             __builtin_popcount(narrow) -
+                             __builtin_popcount(highs | lows)) /
+                            2;
+    utf8 += 16 + static_cast<std::size_t>(extra_bytes);
+    low_count += static_cast<std::size_t>(__builtin_popcount(lows)) / 2;
+    carry = highs >> 30;
+  }
+  if (carry != 0) {
+    // 代理对跨越了块边界，高代理项留给逐个码点处理
+    --i;
+    utf8 -= 2;
+  }
+  lengths = {utf8, i, i - low_count};
+  return i;
+}
+
+// 与mask相与为零的32位单元，每个单元一位
+__attribute__((target("avx2"))) inline int masked_zero_lanes_avx2(
+    __m256i block, __m256i mask) noexcept
+{
+  return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+      _mm256_and_si256(block, mask), _mm256_setzero_si256())));
+}
+
+__attribute__((target("avx2"))) inline int count_masked_zero_avx2(
+    __m256i block, __m256i mask) noexcept
+{
+  return __builtin_popcount(
+      static_cast<unsigned>(masked_zero_lanes_avx2(block, mask)));
+}
+
+template <typename FromChar>
+__attribute__((target("avx2"))) std::size_t validate_utf32_avx2(
+    const FromChar* from, std::size_t count, unicode_lengths& lengths) noexcept
+{
+  const __m256i maximum = _mm256_set1_epi32(0x10ffff);
+  const __m256i non_ascii = _mm256_set1_epi32(static_cast<int>(0xffffff80u));
+  const __m256i wide = _mm256_set1_epi32(static_cast<int>(0xfffff800u));
+  const __m256i supplementary =
+      _mm256_set1_epi32(static_cast<int>(0xffff0000u));
+  const __m256i surrogate = _mm256_set1_epi32(0xd800);
+  std::size_t i = 0;
+  std::size_t utf8 = 0;
+  std::size_t utf16 = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+    const __m256i in_range =
+        _mm256_cmpeq_epi32(_mm256_max_epu32(block, maximum), maximum);
+    const __m256i is_surrogate =
+        _mm256_cmpeq_epi32(_mm256_and_si256(block, wide), surrogate);
+    if (!_mm256_testc_si256(_mm256_andnot_si256(is_surrogate, in_range),
+                            _mm256_set1_epi32(-1))) {
+      break;
+    }
+    const int bmp = count_masked_zero_avx2(block, supplementary);
+    utf8 += static_cast<std::size_t>(32 -
+                                     count_masked_zero_avx2(block, non_ascii) -
+                                     count_masked_zero_avx2(block, wide) - bmp);
+    utf16 += static_cast<std::size_t>(16 - bmp);
+  }
+  lengths = {utf8, utf16, i};
+  return i;
+}
+
+// SIMD校验并计数整块，剩余部分和出错位置逐个码点确定
+template <typename ToChar, typename FromChar>
+__attribute__((target("avx2"))) unicode_measure measure_unicode_avx2(
+    const FromChar* from, std::size_t count) noexcept
+{
+  constexpr unicode_encoding from_encoding =
+      unicode_char_traits<FromChar>::encoding;
+  unicode_lengths lengths{};
+  std::size_t i;
+  if constexpr (from_encoding == unicode_encoding::utf8) {
+    i = validate_utf8_avx2(from, count, lengths);
+  }
+  else if constexpr (from_encoding == unicode_encoding::utf16) {
+    i = validate_utf16_avx2(from, count, lengths);
+  }
+  else {
+    i = validate_utf32_avx2(from, count, lengths);
+  }
+  return measure_unicode_from<ToChar>(
+      from, count, i,
+      unicode_length_for<unicode_char_traits<ToChar>::encoding>(lengths));
+}
+
+// 16字节中恰好是5个三字节序列（常见于连续的中日韩文字）时一次解码，
+// 结果为8个16位单元，后3个无效
+__attribute__((target("avx2"))) inline bool utf8_decode_three_byte_run_avx2(
+    const void* from, __m128i& code_points) noexcept
+{
+  const __m128i window = _mm_loadu_si128(static_cast<const __m128i*>(from));
+  const auto leads = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+      _mm_and_si128(window, _mm_set1_epi8(static_cast<char>(0xf0))),
+      _mm_set1_epi8(static_cast<char>(0xe0)))));
+  // 第0、3、6、9、12字节都是三字节序列的首字节；输入已校验，其余为后续字节
+  if ((leads & 0x1249u) != 0x1249u) {
+    return false;
+  }
+  const __m128i first = _mm_shuffle_epi8(
+      window, _mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, 12, -1, -1, -1, -1, -1,
+                            -1, -1));
+  const __m128i rest = _mm_shuffle_epi8(
+      window,
+      _mm_setr_epi8(2, 1, 5, 4, 8, 7, 11, 10, 14, 13, -1, -1, -1, -1, -1, -1));
+  code_points = _mm_or_si128(
+      _mm_or_si128(_mm_slli_epi16(first, 12),
+                   _mm_srli_epi16(_mm_and_si128(rest, _mm_set1_epi16(0x3f00)),
+                                  2)),
+      _mm_and_si128(rest, _mm_set1_epi16(0x3f)));
+  return true;
+}
+
+// 8个基本多文种平面内、不小于0x800的非代理项各编码为3字节，
+// 写入24字节，之后的4字节无效
+__attribute__((target("avx2"))) inline void utf8_encode_three_byte_run_avx2(
+    __m256i code_points, void* to) noexcept
+{
+  const __m256i first = _mm256_or_si256(_mm256_srli_epi32(code_points, 12),
+                                        _mm256_set1_epi32(0xe0));
+  const __m256i second = _mm256_or_si256(
+      _mm256_and_si256(_mm256_slli_epi32(code_points, 2),
+                       _mm256_set1_epi32(0x3f00)),
+      _mm256_set1_epi32(0x8000));
+  const __m256i third = _mm256_or_si256(
+      _mm256_slli_epi32(_mm256_and_si256(code_points, _mm256_set1_epi32(0x3f)),
+                        16),
+      _mm256_set1_epi32(0x800000));
+  const __m256i packed = _mm256_shuffle_epi8(
+      _mm256_or_si256(_mm256_or_si256(first, second), third),
+      _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12,
+                                                13, 14, -1, -1, -1, -1)));
+  auto* target = static_cast<unsigned char*>(to);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(target),
+                   _mm256_castsi256_si128(packed));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 12),
+                   _mm256_extracti128_si256(packed, 1));
+}
+
+// 8个码点中开头有几个编码为3字节，即在[0x800, 0xffff]内且不是代理项
+__attribute__((target("avx2"))) inline unsigned three_byte_prefix_avx2(
+    __m256i code_points) noexcept
+{
+  const __m256i high = _mm256_and_si256(
+      code_points, _mm256_set1_epi32(static_cast<int>(0xfffff800u)));
+  const __m256i rejected = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi32(high, _mm256_setzero_si256()),
+                      _mm256_cmpeq_epi32(high, _mm256_set1_epi32(0xd800))),
+      _mm256_cmpgt_epi32(code_points, _mm256_set1_epi32(0xffff)));
+  return static_cast<unsigned>(__builtin_ctz(
+      static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(rejected))) |
+      0x100u));
+}
+
+// 输入已校验。整块都能一一对应转换（ASCII，或UTF-16与UTF-32之间的基本多文种平面字符）时
+// 整块转换，只有开头一段能时逐个复制这一段；否则尝试连续的三字节UTF-8序列，
+// 再不行才转换一个码点。整块写入可能越过本块的结果，但不越过整个输出的末尾
+template <typename ToChar, typename FromChar>
+__attribute__((target("avx2"))) void transcode_unicode_avx2(
+    const FromChar* from, std::size_t count, ToChar* to) noexcept
+{
+  using from_codec = unicode_codec<unicode_char_traits<FromChar>::encoding>;
+  using to_codec = unicode_codec<unicode_char_traits<ToChar>::encoding>;
+  constexpr std::size_t from_width = sizeof(FromChar);
+  constexpr std::size_t to_width = sizeof(ToChar);
+  static_assert(from_width != to_width,
+                "same-encoding conversions are copied by transcode_unicode");
+  const __m256i zero = _mm256_setzero_si256();
+  std::size_t i = 0;
+  while (i < count) {
+    // 本块开头能一一对应转换的编码单元数，以及转为UTF-8时编码为3字节的码点数
+    std::size_t simple = 0;
+    unsigned three_bytes = 0;
+    if constexpr (from_width == 1) {
+      if (i + 32 <= count) {
+        const __m256i block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+        const auto non_ascii =
+            static_cast<unsigned>(_mm256_movemask_epi8(block));
+        if (non_ascii == 0) {
+          auto* target = reinterpret_cast<__m256i*>(to);
+          const __m128i low = _mm256_castsi256_si128(block);
+          const __m128i high = _mm256_extracti128_si256(block, 1);
+          if constexpr (to_width == 2) {
+            _mm256_storeu_si256(target, _mm256_cvtepu8_epi16(low));
+            _mm256_storeu_si256(target + 1, _mm256_cvtepu8_epi16(high));
+          }
+          else {
+            _mm256_storeu_si256(target, _mm256_cvtepu8_epi32(low));
+            _mm256_storeu_si256(target + 1,
+                                _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+            _mm256_storeu_si256(target + 2, _mm256_cvtepu8_epi32(high));
+            _mm256_storeu_si256(target + 3,
+                                _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+          }
+          i += 32;
+          to += 32;
+          continue;
+        }
+        simple = static_cast<std::size_t>(__builtin_ctz(non_ascii));
+        // 剩余至少17字节，即至少5个码点，多写的3个单元不会越界
+        __m128i code_points;
+        if (simple == 0 &&
+            utf8_decode_three_byte_run_avx2(from + i, code_points)) {
+          if constexpr (to_width == 2) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(to), code_points);
+          }
+          else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(to),
+                                _mm256_cvtepu16_epi32(code_points));
+          }
+          i += 15;
+          to += 5;
+          continue;
+        }
+      }
+    }
+    else if constexpr (from_width == 2 && to_width == 1) {
+      if (i + 32 <= count) {
+        const auto* block = reinterpret_cast<const __m256i*>(from + i);
+        const __m256i first = _mm256_loadu_si256(block);
+        const __m256i second = _mm256_loadu_si256(block + 1);
+        const __m256i non_ascii = _mm256_set1_epi16(static_cast<short>(0xff80));
+        // 每个16位单元在掩码中占2位
+        const std::uint64_t ascii =
+            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(
+                _mm256_and_si256(first, non_ascii), zero))) |
+            static_cast<std::uint64_t>(
+                static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(
+                    _mm256_and_si256(second, non_ascii), zero))))
+                << 32;
+        if (ascii == ~std::uint64_t(0)) {
+          _mm256_storeu_si256(
+              reinterpret_cast<__m256i*>(to),
+              _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second),
+                                       0xd8));
+          i += 32;
+          to += 32;
+          continue;
+        }
+        simple = static_cast<std::size_t>(__builtin_ctzll(~ascii)) / 2;
+        if (simple == 0) {
+          three_bytes = three_byte_prefix_avx2(
+              _mm256_cvtepu16_epi32(_mm256_castsi256_si128(first)));
+        }
+        // 剩余至少24个单元，多写的4字节不会越界
+        if (three_bytes == 8) {
+          utf8_encode_three_byte_run_avx2(
+              _mm256_cvtepu16_epi32(_mm256_castsi256_si128(first)), to);
+          i += 8;
+          to += 24;
+          continue;
+        }
+      }
+    }
+    else if constexpr (from_width == 2) {
+      if (i + 16 <= count) {
+        const __m256i block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+        const auto surrogates = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi16(
+                _mm256_and_si256(block,
+                                 _mm256_set1_epi16(static_cast<short>(0xf800))),
+                _mm256_set1_epi16(static_cast<short>(0xd800)))));
+        if (surrogates == 0) {
+          auto* target = reinterpret_cast<__m256i*>(to);
+          _mm256_storeu_si256(
+              target, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(block)));
+          _mm256_storeu_si256(
+              target + 1,
+              _mm256_cvtepu16_epi32(_mm256_extracti128_si256(block, 1)));
+          i += 16;
+          to += 16;
+          continue;
+        }
+        simple = static_cast<std::size_t>(__builtin_ctz(surrogates)) / 2;
+      }
+    }
+    else if constexpr (to_width == 1) {
+      if (i + 32 <= count) {
+        const auto* block = reinterpret_cast<const __m256i*>(from + i);
+        const __m256i a = _mm256_loadu_si256(block);
+        const __m256i b = _mm256_loadu_si256(block + 1);
+        const __m256i c = _mm256_loadu_si256(block + 2);
+        const __m256i d = _mm256_loadu_si256(block + 3);
+        const __m256i non_ascii =
+            _mm256_set1_epi32(static_cast<int>(0xffffff80u));
+        const unsigned ascii =
+            static_cast<unsigned>(masked_zero_lanes_avx2(a, non_ascii)) |
+            static_cast<unsigned>(masked_zero_lanes_avx2(b, non_ascii))
+                << 8 |
+            static_cast<unsigned>(masked_zero_lanes_avx2(c, non_ascii))
+                << 16 |
+            static_cast<unsigned>(masked_zero_lanes_avx2(d, non_ascii))
+                << 24;
+        if (ascii == ~0u) {
+          // 两次打包后各128位通道内的顺序为a0-3 b0-3 c0-3 d0-3 | a4-7 b4-7 c4-7 d4-7
+          const __m256i packed = _mm256_packus_epi16(
+              _mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+          _mm256_storeu_si256(
+              reinterpret_cast<__m256i*>(to),
+              _mm256_permutevar8x32_epi32(
+                  packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+          i += 32;
+          to += 32;
+          continue;
+        }
+        simple = static_cast<std::size_t>(__builtin_ctz(~ascii));
+        if (simple == 0) {
+          three_bytes = three_byte_prefix_avx2(a);
+        }
+        if (three_bytes == 8) {
+          utf8_encode_three_byte_run_avx2(a, to);
+          i += 8;
+          to += 24;
+          continue;
+        }
+      }
+    }
+    else {
+      if (i + 16 <= count) {
+        const auto* block = reinterpret_cast<const __m256i*>(from + i);
+        const __m256i a = _mm256_loadu_si256(block);
+        const __m256i b = _mm256_loadu_si256(block + 1);
+        // 输入已校验，不超过0xffff即为基本多文种平面内的非代理项
+        const __m256i supplementary =
+            _mm256_set1_epi32(static_cast<int>(0xffff0000u));
+        const unsigned bmp =
+            static_cast<unsigned>(masked_zero_lanes_avx2(a, supplementary)) |
+            static_cast<unsigned>(masked_zero_lanes_avx2(b, supplementary))
+                << 8;
+        if (bmp == 0xffffu) {
+          _mm256_storeu_si256(
+              reinterpret_cast<__m256i*>(to),
+              _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xd8));
+          i += 16;
+          to += 16;
+          continue;
+        }
+        simple = static_cast<std::size_t>(__builtin_ctz(~bmp));
+      }
+    }
+    if (simple != 0) {
+      for (std::size_t k = 0; k < simple; ++k) {
+        to[k] = static_cast<ToChar>(unicode_unit(from[i + k]));
+      }
+      i += simple;
+      to += simple;
+      continue;
+    }
+    if constexpr (to_width == 1) {
+      for (unsigned k = 0; k < three_bytes; ++k) {
+        const std::uint32_t code_point = unicode_unit(from[i + k]);
+        to[0] = static_cast<ToChar>(0xe0u | (code_point >> 12));
+        to[1] = static_cast<ToChar>(0x80u | ((code_point >> 6) & 0x3fu));
+        to[2] = static_cast<ToChar>(0x80u | (code_point & 0x3fu));
+        to += 3;
+      }
+      if (three_bytes != 0) {
+        i += three_bytes;
+        continue;
+      }
+    }
+    to = to_codec::encode(from_codec::decode_valid(from, i), to);
+  }
+}
+#endif
+
+template <typename ToChar, typename FromChar>
+struct unicode_kernels
+{
+  unicode_measure (*measure)(const FromChar* from, std::size_t count) noexcept;
+  void (*transcode)(const FromChar* from, std::size_t count,
+                    ToChar* to) noexcept;
+};
+
+template <typename ToChar, typename FromChar>
+const unicode_kernels<ToChar, FromChar>& select_unicode_kernels() noexcept
+{
+  static const unicode_kernels<ToChar, FromChar> kernels = [] {
+    unicode_kernels<ToChar, FromChar> selected{
+        &measure_unicode_portable<ToChar, FromChar>,
+        &transcode_unicode_portable<ToChar, FromChar>};
+#ifdef AUTO_CAST_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      selected.measure = &measure_unicode_avx2<ToChar, FromChar>;
+      if constexpr (sizeof(ToChar) != sizeof(FromChar)) {
+        selected.transcode = &transcode_unicode_avx2<ToChar, FromChar>;
+      }
+    }
+#endif
+    return selected;
+  }();
+  return kernels;
+}
+
+// 第一遍：校验输入并计算目标编码单元数
+template <typename ToChar, typename FromChar>
+unicode_measure measure_unicode(const FromChar* from,
+                                std::size_t count) noexcept
+{
+  return select_unicode_kernels<ToChar, FromChar>().measure(from, count);
+}
+
+// 第二遍：输入已校验，写入measure_unicode给出的长度
+template <typename ToChar, typename FromChar>
+void transcode_unicode(const FromChar* from, std::size_t count,
+                       ToChar* to) noexcept
+{
+  if constexpr (unicode_char_traits<FromChar>::encoding ==
+                unicode_char_traits<ToChar>::encoding) {
+    // 同一编码只是编码单元类型不同
+    static_assert(sizeof(FromChar) == sizeof(ToChar));
+    if (count != 0) {
+      std::memcpy(to, from, count * sizeof(ToChar));
+    }
+  }
+  else {
+    select_unicode_kernels<ToChar, FromChar>().transcode(from, count, to);
+  }
+}
+
+// 先校验并计算长度，结果字符串只分配一次；非法输入抛出unicode_error
+template <typename To, typename From>
+To unicode_cast(From from)
+{
+  using to_char =
+      typename unicode_string_traits<std::remove_cv_t<To>>::char_type;
+  const unicode_measure measured =
+      measure_unicode<to_char>(from.data(), from.size());
+  if (!measured.valid()) {
+    throw unicode_error(measured.error_position);
+  }
+  std::remove_cv_t<To> result;
+  result.resize(measured.length);
+  transcode_unicode(from.data(), from.size(), &result[0]);
+  return result;
+}
+
+// auto_cast_impl选择的转换种类
+enum class cast_kind
+{
+  same_type,
+  const_removal,
+  up_cast,
+  down_cast_polymorphic,
+  down_cast_checked,
+  down_cast_non_polymorphic,
+  standard_pointer_integer,
+  generic_pointer_integer,
+  standard_conversion,
+  reinterpret,
+  packed_pointer,
+  offset_pointer,
+  half_precision,
+  callable,
+  aggregate,
+  unicode,
+  invalid
+};
+
+template <typename To, typename From, typename Policy>
+struct auto_cast_traits;
+
+template <typename To, typename From, typename Policy>
+struct is_zero_overhead_cast
+    : std::bool_constant<auto_cast_traits<To, From, Policy>::zero_overhead>
+{
+};
+
+// 零开销策略下转换必须是零开销的；其他策略不会实例化auto_cast_traits
+template <typename To, typename From, typename Policy>
+struct satisfies_zero_overhead_policy
+    : std::disjunction<std::negation<is_zero_overhead_policy<Policy>>,
+                       is_zero_overhead_cast<To, From, Policy>>
+{
+};
+
+#if __cplusplus >= 202002
+
+template <typename To, typename From, is_cast_policy Policy = default_policy>
+class auto_cast_impl
+{
+private:
+  // 使用策略标志
+  static constexpr bool allow_reinterpret = Policy::allow_reinterpret;
+  static constexpr bool allow_const_removal = Policy::allow_const_removal;
+  static constexpr bool allow_non_polymorphic_downcast =
+      Policy::allow_non_polymorphic_downcast;
+  static constexpr bool allow_standard_pointer_integer_cast =
+      Policy::allow_standard_pointer_integer_cast;
+
+  // 编译时错误信息
+  template <bool Condition>
+  struct static_check
+  {
+    static_assert(
+        Condition,
+        "auto_cast<>: This conversion is not allowed by the current policy");
+  };
+
+  // 编译时错误信息（特定于reinterpret_cast）
+  struct reinterpret_not_allowed
+  {
+    static_assert(
+        allow_reinterpret,
+        "auto_cast<>: reinterpret_cast is not allowed by the current policy. "
+        "Consider using auto_cast<To, unsafe_policy> or auto_cast_unsafe<To>.");
+  };
+
+  // 编译时错误信息（特定于去const）
+  struct const_removal_not_allowed
+  {
+    static_assert(allow_const_removal,
+                  "auto_cast<>: Removing const qualification is not allowed by "
+                  "the current policy. "
+                  "Consider using auto_cast<To, default_policy> instead of "
+                  "auto_cast<To, strict_policy>.");
+  };
+
+  // 编译时错误信息（特定于非多态向下转换）
+  struct non_polymorphic_downcast_not_allowed
+  {
+    static_assert(allow_non_polymorphic_downcast,
+                  "auto_cast<>: Non-polymorphic downcast is not allowed by the "
+                  "current policy. "
+                  "Consider using auto_cast<To, default_policy> instead of "
+                  "auto_cast<To, strict_policy>.");
+  };
+
+  struct standard_pointer_integer_cast_not_allowed
+  {
+    static_assert(
+        allow_standard_pointer_integer_cast,
+        "auto_cast<>: standard pointer integer cast is not allowed by the "
+        "current policy. "
+        "Consider using auto_cast<To, default_policy> instead of "
+        "auto_cast<To, strict_policy>.");
+  };
+
+  // 基本类型转换实现
+  template <typename T = To, typename F = From>
+  static T same_type_cast(F from) noexcept
+    requires(std::is_same_v<T, F>)
+  {
+    return from;
+  }
+
+  // 去const转换（检查策略）
+  template <typename T = To, typename F = From>
+  static T remove_const_cast(F from) noexcept
+    requires(std::is_same_v<std::remove_const_t<T>, std::remove_const_t<F>> &&
+             !std::is_same_v<T, F> && !static_cast<bool>(std::is_const_v<T>) &&
+             static_cast<bool>(std::is_const_v<F>))
+  {
+    static_check<allow_const_removal> check;
+    return const_cast<T>(from);
+  }
+
+  // 向上转换
+  template <typename T = To, typename F = From>
+  static T up_cast(F from) noexcept
+    requires(
+        std::is_base_of_v<std::remove_pointer_t<T>, std::remove_pointer_t<F>> &&
+        (is_pointer_like_v<T> && is_pointer_like_v<F>))
+  {
+    return static_cast<T>(from);
+  }
+
+  template <typename T = To, typename F = From>
+  static T up_cast(F from) noexcept
+    requires(std::is_base_of_v<T, F> &&
+             (is_reference_like_v<T> && is_reference_like_v<F>))
+  {
+    return static_cast<T>(from);
+  }
+
+  // 向下转换 - 多态类型用dynamic_cast
+  template <typename T = To, typename F = From>
+  static T safe_down_cast(F from)
+    requires(
+        std::is_base_of_v<std::remove_pointer_t<F>, std::remove_pointer_t<T>> &&
+        std::is_polymorphic_v<std::remove_pointer_t<F>> &&
+        (is_pointer_like_v<T> && is_pointer_like_v<F>))
+  {
+    auto result = profiled_down_cast<T>(from);
+    if (!result && from) {
+      throw std::bad_cast();
+    }
+    return result;
+  }
+
+  template <typename T = To, typename F = From>
+  static T safe_down_cast(F from)
+    requires(std::is_base_of_v<F, T> && std::is_polymorphic_v<F> &&
+             (is_reference_like_v<T> && is_reference_like_v<F>))
+  {
+    using raw_to = std::remove_reference_t<T>;
+    auto* ptr = profiled_down_cast<raw_to*>(&from);
+    if (!ptr) {
+      throw std::bad_cast();
+    }
+    return static_cast<T>(*ptr);
+  }
+
+  // 向下转换 - 调试版本检查，发布版本static_cast
+  template <typename T = To, typename F = From>
+  static T checked_down_cast(F from) noexcept
+    requires(
+        std::is_base_of_v<std::remove_pointer_t<F>, std::remove_pointer_t<T>> &&
+        std::is_polymorphic_v<std::remove_pointer_t<F>> &&
+        (is_pointer_like_v<T> && is_pointer_like_v<F>))
+  {
+#ifdef NDEBUG
+    if constexpr (is_static_down_castable<T, F>::value) {
+      return static_cast<T>(from);
+    }
+    else {
+      return dynamic_cast<T>(from);
+    }
+#else
+    auto result = dynamic_cast<T>(from);
+    assert((result || !from) && "auto_cast<>: invalid checked downcast");
+    return result;
+#endif
+  }
+
+  template <typename T = To, typename F = From>
+  static T checked_down_cast(F from) noexcept
+    requires(std::is_base_of_v<std::remove_reference_t<F>,
+                               std::remove_reference_t<T>> &&
+             std::is_polymorphic_v<std::remove_reference_t<F>> &&
+             (is_reference_like_v<T> && is_reference_like_v<F>))
+  {
+    using raw_to = std::remove_reference_t<T>;
+#ifdef NDEBUG
+    if constexpr (is_static_down_castable<T, F>::value) {
+      return static_cast<T>(from);
+    }
+    else {
+      return static_cast<T>(*dynamic_cast<raw_to*>(&from));
+    }
+#else
+    auto* ptr = dynamic_cast<raw_to*>(&from);
+    assert(ptr && "auto_cast<>: invalid checked downcast");
+    return static_cast<T>(*ptr);
+#endif
+  }
+
+  // 向下转换 - 非多态类型用static_cast（检查策略）
+  template <typename T = To, typename F = From>
+  static T unsafe_down_cast(F from) noexcept
+    requires(
+        std::is_base_of_v<std::remove_pointer_t<F>, std::remove_pointer_t<T>> &&
+        !std::is_polymorphic_v<std::remove_pointer_t<F>> &&
+        (is_pointer_like_v<T> || is_reference_like_v<T>) &&
+        (is_pointer_like_v<F> || is_reference_like_v<F>))
+  {
+    static_check<allow_non_polymorphic_downcast> check;
+    return static_cast<T>(from);
+  }
+
+  // 标准转换
+  template <typename T = To, typename F = From>
+  static T standard_cast(F from) noexcept(noexcept(static_cast<T>(from)))
+    requires(!std::is_same_v<T, F> && std::is_convertible_v<F, T> &&
+             !std::is_base_of_v<T, F> && !std::is_base_of_v<F, T> &&
+             !std::is_const_v<F>)
+  {
+    return static_cast<T>(from);
+  }
+
+  // 打包指针（tagged_ptr / compressed_ptr）与裸指针之间的转换
+  template <typename T = To, typename F = From>
+  static T packed_pointer_conversion(F from)
+    requires(is_pointer_to_packed_conversion<T, F>() ||
+             is_packed_to_pointer_conversion<T, F>())
+  {
+    static_assert(!is_lossy_packed_pointer<F>() ||
+                      policy_allows_pointer_bit_drop<Policy>::value,
+                  "auto_cast<>: Dropping the tag bits of a tagged pointer is "
+                  "not allowed by the current policy. "
+                  "Use tagged_ptr<>::get() explicitly or "
+                  "auto_cast<To, default_policy>.");
+    return packed_pointer_cast<T>(from);
+  }
+
+  // 自相对指针转换：指向类型之间的转换按当前策略递归分派（含基类偏移调整）
+  template <typename T = To, typename F = From>
+  static T offset_pointer_conversion(F from)
+    requires(is_offset_pointer_conversion<T, F>())
+  {
+    using to_traits = offset_pointer_traits<std::remove_cv_t<T>>;
+    using from_traits = offset_pointer_traits<std::remove_cv_t<F>>;
+    return to_traits::wrap(
+        auto_cast_impl<typename to_traits::pointer,
+                       typename from_traits::pointer,
+                       Policy>::cast(from_traits::unwrap(from)));
+  }
+
+  // 半精度浮点转换
+  template <typename T = To, typename F = From>
+  static T half_precision_conversion(F from) noexcept
+    requires(is_half_precision_conversion<T, F>())
+  {
+    return half_precision_cast<T>(from);
+  }
+
+  // 强制重新解释转换（检查策略）
+  template <typename T = To, typename F = From>
+  static T reinterpret_cast_impl(F from) noexcept
+    requires(allow_reinterpret &&
+             ((is_pointer_like_v<T> && is_pointer_like_v<F>) ||
+              (std::is_integral_v<T> && is_pointer_like_v<F>) ||
+              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+  {
+    return reinterpret_cast<T>(from);
+  }
+
+  // reinterpret_cast不允许的版本
+  template <typename T = To, typename F = From>
+  static T reinterpret_cast_impl(F /*unused*/) noexcept
+    requires(!allow_reinterpret &&
+             ((is_pointer_like_v<T> && is_pointer_like_v<F>) ||
+              (std::is_integral_v<T> && is_pointer_like_v<F>) ||
+              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+  {
+    // 触发编译时错误
+    reinterpret_not_allowed error;
+    return T{};
+  }
+
+  template <typename T = To, typename F = From>
+  static T standard_pointer_integer_cast(F from) noexcept
+    requires(allow_standard_pointer_integer_cast &&
+             ((std::is_integral_v<T> && is_pointer_like_v<F>) ||
+              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+  {
+    return reinterpret_cast<T>(from);
+  }
+
+  template <typename T = To, typename F = From>
+  static T standard_pointer_integer_cast(F /*from*/) noexcept
+    requires(!allow_standard_pointer_integer_cast &&
+             ((std::is_integral_v<T> && is_pointer_like_v<F>) ||
+              (is_pointer_like_v<T> && std::is_integral_v<F>)))
+  {
+    standard_pointer_integer_cast_not_allowed error;
+    return T{};
+  }
+
+public:
+  // 与cast()的分派顺序保持一致
+  static constexpr cast_kind kind() noexcept
+  {
+    if constexpr (std::is_same_v<To, From>) {
+      return cast_kind::same_type;
+    }
+    else if constexpr (std::is_same_v<std::remove_const_t<To>,
+                                      std::remove_const_t<From>>) {
+      if constexpr (std::is_const_v<From> && !std::is_const_v<To>) {
+        return cast_kind::const_removal;
+      }
+      else {
+        return cast_kind::standard_conversion;
+      }
+    }
+    else if constexpr (std::is_base_of_v<std::remove_pointer_t<To>,
+                                         std::remove_pointer_t<From>>) {
+      return cast_kind::up_cast;
+    }
+    else if constexpr (std::is_base_of_v<std::remove_pointer_t<From>,
+                                         std::remove_pointer_t<To>>) {
+      if constexpr (std::is_polymorphic_v<std::remove_pointer_t<From>> &&
+                    is_assert_checked_policy<Policy>::value) {
+        return cast_kind::down_cast_checked;
+      }
+      else if constexpr (std::is_polymorphic_v<std::remove_pointer_t<From>>) {
+        return cast_kind::down_cast_polymorphic;
+      }
+      else {
+        return cast_kind::down_cast_non_polymorphic;
+      }
+    }
+    else if constexpr (is_half_precision_conversion<To, From>()) {
+      return cast_kind::half_precision;
+    }
+    else if constexpr (is_pointer_to_packed_conversion<To, From>() ||
+                       is_packed_to_pointer_conversion<To, From>()) {
+      return cast_kind::packed_pointer;
+    }
+    else if constexpr (is_offset_pointer_conversion<To, From>()) {
+      return cast_kind::offset_pointer;
+    }
+    else if constexpr (is_callable_conversion<To, From>()) {
+      return is_valid_callable_conversion<To, From>() ? cast_kind::callable
+                                                      : cast_kind::invalid;
+    }
+    else if constexpr (is_aggregate_conversion<To, From>()) {
+      return cast_kind::aggregate;
+    }
+    else if constexpr (is_unicode_conversion<To, From>()) {
+      return cast_kind::unicode;
+    }
+    else if constexpr (std::is_convertible_v<From, To>) {
+      return cast_kind::standard_conversion;
+    }
+    else if constexpr (is_standard_pointer_integer_conversion<From, To>) {
+      return cast_kind::standard_pointer_integer;
+    }
+    else if constexpr ((is_pointer_like_v<To> && is_pointer_like_v<From>) ||
+                       (std::is_integral_v<To> && is_pointer_like_v<From>) ||
+                       (is_pointer_like_v<To> && std::is_integral_v<From>)) {
+      return cast_kind::reinterpret;
+    }
+    else {
+      return cast_kind::invalid;
+    }
+  }
+
+  static To cast(From from)
+  {
+    static_assert(satisfies_zero_overhead_policy<To, From, Policy>::value,
+                  "auto_cast<>: This conversion is not guaranteed to be a "
+                  "register move plus an offset add, which zero_overhead_policy "
+                  "requires. Check auto_cast_traits<To, From, Policy>::kind.");
+    // 按优先级尝试不同的转换
+    if constexpr (std::is_same_v<To, From>) {
+      return same_type_cast(from);
+    }
+    else if constexpr (std::is_same_v<std::remove_const_t<To>,
+                                      std::remove_const_t<From>>) {
+      // 只有const不同的类型
+      if constexpr (std::is_const_v<From> && !std::is_const_v<To>) {
+        return remove_const_cast(from);
+      }
+      else {
+        return static_cast<To>(from);
+      }
+    }
+    else if constexpr (std::is_base_of_v<std::remove_pointer_t<To>,
+                                         std::remove_pointer_t<From>>) {
+      // 向上转换总是安全的
+      return up_cast(from);
+    }
+    else if constexpr (std::is_base_of_v<std::remove_pointer_t<From>,
+                                         std::remove_pointer_t<To>>) {
+      // 向下转换
+      if constexpr (std::is_polymorphic_v<std::remove_pointer_t<From>> &&
+                    is_assert_checked_policy<Policy>::value) {
+        return checked_down_cast(from);
+      }
+      else if constexpr (std::is_polymorphic_v<std::remove_pointer_t<From>>) {
+        return safe_down_cast(from);
+      }
+      else {
+        return unsafe_down_cast(from);
+      }
+    }
+    else if constexpr (is_half_precision_conversion<To, From>()) {
+      // 半精度浮点转换
+      return half_precision_conversion(from);
+    }
+    else if constexpr (is_pointer_to_packed_conversion<To, From>() ||
+                       is_packed_to_pointer_conversion<To, From>()) {
+      // 打包指针转换
+      return packed_pointer_conversion(from);
+    }
+    else if constexpr (is_offset_pointer_conversion<To, From>()) {
+      // 自相对指针转换
+      return offset_pointer_conversion(from);
+    }
+    else if constexpr (is_callable_conversion<To, From>()) {
+      // 可调用对象转换
+      return callable_cast<To>(from);
+    }
+    else if constexpr (is_aggregate_conversion<To, From>()) {
+      // 聚合体逐字段转换
+      return aggregate_cast<To, Policy>(from);
+    }
+    else if constexpr (is_unicode_conversion<To, From>()) {
+      // Unicode转码
+      return unicode_cast<To>(from);
+    }
+    else if constexpr (std::is_convertible_v<From, To>) {
+      // 标准转换
+      return standard_cast(from);
+    }
+    else if constexpr (is_standard_pointer_integer_conversion<From, To>) {
+      return standard_pointer_integer_cast(from);
+    }
+    else if constexpr ((is_pointer_like_v<To> && is_pointer_like_v<From>) ||
+                       (std::is_integral_v<To> && is_pointer_like_v<From>) ||
+                       (is_pointer_like_v<To> && std::is_integral_v<From>)) {
+      // 强制重新解释转换
+      return reinterpret_cast_impl(from);
+    }
+    else {
+      static_assert(sizeof(From) == 0,
+                    "auto_cast<>: No suitable conversion found between types");
+    }
+  }
+};
+
+#elif CPP_11
+
+template <typename To, typename From, typename Policy>
+struct auto_cast_impl;
+
+// 转换标签
+struct same_type_tag
+{
+};
+struct up_cast_tag
+{
+};
+struct down_cast_polymorphic_tag
+{
+};
+struct down_cast_checked_tag
+{
+};
+struct down_cast_non_polymorphic_tag
+{
+};
+struct const_removal_tag
+{
+};
+struct standard_pointer_integer_tag
+{
+};
+struct generic_pointer_integer_tag
+{
+};
+struct standard_conversion_tag
+{
+};
+struct reinterpret_cast_tag
+{
+};
+template <typename Policy>
+struct packed_pointer_tag
+{
+};
+template <typename Policy>
+struct offset_pointer_tag
+{
+};
+struct half_precision_tag
+{
+};
+struct callable_tag
+{
+};
+struct invalid_callable_tag
+{
+};
+template <typename Policy>
+struct aggregate_tag
+{
+};
+struct unicode_tag
+{
+};
+struct invalid_cast_tag
+{
+};
+
+// 类型特征辅助
+template <typename T>
+struct remove_cv_ptr
+{
+  using type = std::remove_cv_t<std::remove_pointer_t<T>>;
+};
+
+template <typename T>
+using remove_cv_ptr_t = typename remove_cv_ptr<T>::type;
+
+// 辅助检查函数
+template <typename To, typename From>
+constexpr bool is_up_cast_impl()
+{
+  return std::is_pointer<To>::value && std::is_pointer<From>::value &&
+         std::is_base_of<remove_cv_ptr_t<To>, remove_cv_ptr_t<From>>::value;
+}
+
+template <typename To, typename From>
+constexpr bool is_down_cast_impl()
+{
+  return std::is_pointer<To>::value && std::is_pointer<From>::value &&
+         std::is_base_of<remove_cv_ptr_t<From>, remove_cv_ptr_t<To>>::value;
+}
+
+// 递归标签分发器
+template <typename To, typename From, typename Policy, int Step = 0>
+struct get_cast_tag
+{
+  using type = typename get_cast_tag<To, From, Policy, Step + 1>::type;
+};
+
+// Step 0: 检查相同类型
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 0>
+{
+  using type = typename std::conditional<
+      std::is_same<To, From>::value, same_type_tag,
+      typename get_cast_tag<To, From, Policy, 1>::type>::type;
+};
+// Step 1: 检查去const转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 1>
+{
+private:
+  static constexpr bool is_same_underlying =
+      std::is_same<remove_cv_ptr_t<To>, remove_cv_ptr_t<From>>::value;
+  static constexpr bool is_const_removal =
+      is_same_underlying && !std::is_same<To, From>::value &&
+      !std::is_const<remove_cv_ptr_t<To>>::value &&
+      std::is_const<remove_cv_ptr_t<From>>::value;
+
+public:
+  using type = typename std::conditional<
+      is_const_removal && Policy::allow_const_removal, const_removal_tag,
+      typename get_cast_tag<To, From, Policy, 2>::type>::type;
+};
+// Step 2: 检查向上转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 2>
+{
+  using type =
+      std::conditional_t<is_up_cast_impl<To, From>(), up_cast_tag,
+                         typename get_cast_tag<To, From, Policy, 3>::type>;
+};
+
+// Step 3: 检查向下转换（多态）
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 3>
+{
+  using type = typename std::conditional<
+      is_down_cast_impl<To, From>() &&
+          std::is_polymorphic<remove_cv_ptr_t<From>>::value,
+      typename std::conditional<is_assert_checked_policy<Policy>::value,
+                                down_cast_checked_tag,
+                                down_cast_polymorphic_tag>::type,
+      typename get_cast_tag<To, From, Policy, 4>::type>::type;
+};
+
+// Step 4: 检查向下转换（非多态）
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 4>
+{
+  using type = typename std::conditional<
+      is_down_cast_impl<To, From>() &&
+          !std::is_polymorphic<remove_cv_ptr_t<From>>::value &&
+          Policy::allow_non_polymorphic_downcast,
+      down_cast_non_polymorphic_tag,
+      typename get_cast_tag<To, From, Policy, 5>::type>::type;
+};
+
+// Step 5: 检查标准指针?整数转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 5>
+{
+private:
+  template <typename T>
+  static constexpr bool is_standard_int()
+  {
+    return std::is_same<T, std::intptr_t>::value ||
+           std::is_same<T, std::uintptr_t>::value;
+  }
+
+public:
+  using type = std::conditional_t<
+      ((std::is_pointer<From>::value && is_standard_int<To>()) ||
+       (is_standard_int<From>() && std::is_pointer<To>::value)) &&
+          Policy::allow_standard_pointer_integer_cast,
+      standard_pointer_integer_tag,
+      typename get_cast_tag<To, From, Policy, 6>::type>;
+};
+
+// Step 6: 检查通用指针?整数转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 6>
+{
+  using type = std::conditional_t<
+      ((std::is_pointer<From>::value && std::is_integral<To>::value) ||
+       (std::is_integral<From>::value && std::is_pointer<To>::value)) &&
+          Policy::allow_reinterpret,
+      generic_pointer_integer_tag,
+      typename get_cast_tag<To, From, Policy, 7>::type>;
+};
+
+// Step 7: 检查标准转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 7>
+{
+  using type =
+      std::conditional_t<std::is_convertible<From, To>::value &&
+                             !is_half_precision_conversion<To, From>() &&
+                             !is_callable_conversion<To, From>() &&
+                             !is_aggregate_conversion<To, From>(),
+                         standard_conversion_tag,
+                         typename get_cast_tag<To, From, Policy, 8>::type>;
+};
+
+// Step 8: 检查不相关指针类型的reinterpret_cast
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 8>
+{
+  using type = std::conditional_t<
+      std::is_pointer<To>::value && std::is_pointer<From>::value &&
+          Policy::allow_reinterpret,
+      reinterpret_cast_tag, typename get_cast_tag<To, From, Policy, 9>::type>;
+};
+
+// Step 9: 检查打包指针与裸指针之间的转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 9>
+{
+  using type = std::conditional_t<
+      is_pointer_to_packed_conversion<To, From>() ||
+          is_packed_to_pointer_conversion<To, From>(),
+      packed_pointer_tag<Policy>,
+      typename get_cast_tag<To, From, Policy, 10>::type>;
+};
+
+// Step 10: 检查自相对指针转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 10>
+{
+  using type = std::conditional_t<is_offset_pointer_conversion<To, From>(),
+                                  offset_pointer_tag<Policy>,
+                                  typename get_cast_tag<To, From, Policy,
+                                                        11>::type>;
+};
+
+// Step 11: 检查半精度浮点转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 11>
+{
+  using type =
+      std::conditional_t<is_half_precision_conversion<To, From>(),
+                         half_precision_tag,
+                         typename get_cast_tag<To, From, Policy, 12>::type>;
+};
+
+// Step 12: 检查可调用对象转换，无效的转换单独报错
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 12>
+{
+  using type = std::conditional_t<
+      is_callable_conversion<To, From>(),
+      std::conditional_t<is_valid_callable_conversion<To, From>(),
+                         callable_tag, invalid_callable_tag>,
+      typename get_cast_tag<To, From, Policy, 13>::type>;
+};
+
+// Step 13: 检查已启用的聚合体逐字段转换
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 13>
+{
+  using type = std::conditional_t<is_aggregate_conversion<To, From>(),
+                                  aggregate_tag<Policy>,
+                                  typename get_cast_tag<To, From, Policy,
+                                                        14>::type>;
+};
+
+// Step 14: 检查Unicode字符串转码
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 14>
+{
+  using type =
+      std::conditional_t<is_unicode_conversion<To, From>(), unicode_tag,
+                         typename get_cast_tag<To, From, Policy, 15>::type>;
+};
+
+// Step 15: 无法转换（递归终止）
+template <typename To, typename From, typename Policy>
+struct get_cast_tag<To, From, Policy, 15>
+{
+  using type = invalid_cast_tag;
+};
+
+// 转换实现函数
+template <typename To, typename From>
+To cast_impl(From from, same_type_tag)
+{
+  return from;
+}
+
+template <typename To, typename From>
+To cast_impl(From from, up_cast_tag)
+{
+  return static_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, down_cast_polymorphic_tag)
+{
+  auto result = profiled_down_cast<To>(from);
+  if (!result && from) {
+    throw std::bad_cast();
+  }
+  return result;
+}
+
+template <typename To, typename From>
+To cast_impl(From from, down_cast_non_polymorphic_tag)
+{
+  return static_cast<To>(from);
+}
+
+template <typename To, typename From>
+To checked_down_cast_release(From from, std::true_type /*static_castable*/)
+{
+  return static_cast<To>(from);
+}
+
+template <typename To, typename From>
+To checked_down_cast_release(From from, std::false_type /*static_castable*/)
+{
+  return dynamic_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, down_cast_checked_tag)
+{
+#ifdef NDEBUG
+  // 与C++20路径一致：虚基类无法static_cast时用dynamic_cast，失败返回空指针而不抛出
+  return checked_down_cast_release<To>(
+      from, std::integral_constant<
+                bool, is_static_down_castable<To, From>::value>{});
+#else
+  auto result = dynamic_cast<To>(from);
+  assert((result || !from) && "auto_cast: invalid checked downcast");
+  return result;
+#endif
+}
+
+template <typename To, typename From>
+To cast_impl(From from, const_removal_tag)
+{
+  return const_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, standard_pointer_integer_tag)
+{
+  return reinterpret_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, generic_pointer_integer_tag)
+{
+  // 检查整数类型是否足够大
+  static_assert(
+      !(std::is_pointer<From>::value && std::is_integral<To>::value) ||
+          (sizeof(To) >= sizeof(void*)),
+      "Integer type is too small to hold a pointer");
+  return reinterpret_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, standard_conversion_tag)
+{
+  return static_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, reinterpret_cast_tag)
+{
+  return reinterpret_cast<To>(from);
+}
+
+// 丢弃标记位的转换由策略决定，在这里报错而不是落到“没有合适的转换”
+template <typename To, typename From, typename Policy>
+To cast_impl(From from, packed_pointer_tag<Policy>)
+{
+  static_assert(!is_lossy_packed_pointer<From>() ||
+                    policy_allows_pointer_bit_drop<Policy>::value,
+                "auto_cast: Dropping the tag bits of a tagged pointer is "
+                "not allowed by the current policy. "
+                "Use tagged_ptr<>::get() explicitly or "
+                "auto_cast<To, default_policy>.");
+  return packed_pointer_cast<To>(from);
+}
+
+// 指向类型之间的转换按同一策略递归分派
+template <typename To, typename From, typename Policy>
+To cast_impl(From from, offset_pointer_tag<Policy>)
+{
+  using to_traits = offset_pointer_traits<std::remove_cv_t<To>>;
+  using from_traits = offset_pointer_traits<std::remove_cv_t<From>>;
+  return to_traits::wrap(
+      auto_cast_impl<typename to_traits::pointer, typename from_traits::pointer,
+                     Policy>::cast(from_traits::unwrap(from)));
+}
+
+template <typename To, typename From>
+To cast_impl(From from, half_precision_tag)
+{
+  return half_precision_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, callable_tag)
+{
+  return callable_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, invalid_callable_tag)
+{
+  return callable_cast<To>(from);
+}
+
+template <typename To, typename From, typename Policy>
+To cast_impl(From from, aggregate_tag<Policy>)
+{
+  return aggregate_cast<To, Policy>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From from, unicode_tag)
+{
+  return unicode_cast<To>(from);
+}
+
+template <typename To, typename From>
+To cast_impl(From /*unused*/, invalid_cast_tag /*unused*/)
+{
+  static_assert(sizeof(To) == 0,
+                "auto_cast: No suitable conversion found between types");
+  using T = remove_cv_ptr_t<To>;
+  return T{};
+}
+
+// 转换标签对应的转换种类
+constexpr cast_kind cast_kind_of(same_type_tag) noexcept
+{
+  return cast_kind::same_type;
+}
+constexpr cast_kind cast_kind_of(const_removal_tag) noexcept
+{
+  return cast_kind::const_removal;
+}
+constexpr cast_kind cast_kind_of(up_cast_tag) noexcept
+{
+  return cast_kind::up_cast;
+}
+constexpr cast_kind cast_kind_of(down_cast_polymorphic_tag) noexcept
+{
+  return cast_kind::down_cast_polymorphic;
+}
+constexpr cast_kind cast_kind_of(down_cast_checked_tag) noexcept
+{
+  return cast_kind::down_cast_checked;
+}
+constexpr cast_kind cast_kind_of(down_cast_non_polymorphic_tag) noexcept
+{
+  return cast_kind::down_cast_non_polymorphic;
+}
+constexpr cast_kind cast_kind_of(standard_pointer_integer_tag) noexcept
+{
+  return cast_kind::standard_pointer_integer;
+}
+constexpr cast_kind cast_kind_of(generic_pointer_integer_tag) noexcept
+{
+  return cast_kind::generic_pointer_integer;
+}
+constexpr cast_kind cast_kind_of(standard_conversion_tag) noexcept
+{
+  return cast_kind::standard_conversion;
+}
+constexpr cast_kind cast_kind_of(reinterpret_cast_tag) noexcept
+{
+  return cast_kind::reinterpret;
+}
+template <typename Policy>
+constexpr cast_kind cast_kind_of(packed_pointer_tag<Policy>) noexcept
+{
+  return cast_kind::packed_pointer;
+}
+template <typename Policy>
+constexpr cast_kind cast_kind_of(offset_pointer_tag<Policy>) noexcept
+{
+  return cast_kind::offset_pointer;
+}
+constexpr cast_kind cast_kind_of(half_precision_tag) noexcept
+{
+  return cast_kind::half_precision;
+}
+constexpr cast_kind cast_kind_of(callable_tag) noexcept
+{
+  return cast_kind::callable;
+}
+constexpr cast_kind cast_kind_of(invalid_callable_tag) noexcept
+{
+  return cast_kind::invalid;
+}
+template <typename Policy>
+constexpr cast_kind cast_kind_of(aggregate_tag<Policy>) noexcept
+{
+  return cast_kind::aggregate;
+}
+constexpr cast_kind cast_kind_of(unicode_tag) noexcept
+{
+  return cast_kind::unicode;
+}
+constexpr cast_kind cast_kind_of(invalid_cast_tag) noexcept
+{
+  return cast_kind::invalid;
+}
+
+template <typename To, typename From, typename Policy = default_policy>
+struct auto_cast_impl
+{
+  static constexpr cast_kind kind() noexcept
+  {
+    return cast_kind_of(typename get_cast_tag<To, From, Policy>::type{});
+  }
+
+  static To cast(From from)
+  {
+    static_assert(satisfies_zero_overhead_policy<To, From, Policy>::value,
+                  "auto_cast: This conversion is not guaranteed to be a "
+                  "register move plus an offset add, which zero_overhead_policy "
+                  "requires. Check auto_cast_traits<To, From, Policy>::kind.");
+    using tag = typename get_cast_tag<To, From, Policy>::type;
+    return cast_impl<To, From>(from, tag{});
+  }
+};
+
+#endif
+
+// 转换开销查询，自相对指针的开销取决于指向类型之间的转换，聚合体取决于各字段的转换
+template <typename To, typename From, typename Policy>
+constexpr bool cast_uses_rtti() noexcept;
+
+template <typename To, typename From, typename Policy>
+constexpr bool cast_is_noexcept() noexcept;
+
+template <typename To, typename From, typename Policy>
+constexpr bool cast_may_allocate() noexcept;
+
+// 聚合体各字段转换的开销：任一字段使用RTTI / 可能抛出 / 可能分配
+template <typename To, typename From, typename Policy, std::size_t... I>
+constexpr bool aggregate_fields_use_rtti(std::index_sequence<I...>) noexcept
+{
+  using plan = aggregate_conversion_plan<To, From>;
+  return (cast_uses_rtti<typename plan::template to_field<I>,
+                         typename plan::template from_field<I>, Policy>() ||
+          ...);
+}
+
+template <typename To, typename From, typename Policy, std::size_t... I>
+constexpr bool aggregate_fields_are_noexcept(std::index_sequence<I...>) noexcept
+{
+  using plan = aggregate_conversion_plan<To, From>;
+  return (cast_is_noexcept<typename plan::template to_field<I>,
+                           typename plan::template from_field<I>, Policy>() &&
+          ...);
+}
+
+template <typename To, typename From, typename Policy, std::size_t... I>
+constexpr bool aggregate_fields_may_allocate(std::index_sequence<I...>) noexcept
+{
+  using plan = aggregate_conversion_plan<To, From>;
+  return (cast_may_allocate<typename plan::template to_field<I>,
+                            typename plan::template from_field<I>, Policy>() ||
+          ...);
+}
+
+template <typename To, typename From, typename Policy>
+constexpr bool cast_uses_rtti() noexcept
+{
+  constexpr cast_kind kind = auto_cast_impl<To, From, Policy>::kind();
+  if constexpr (kind == cast_kind::down_cast_polymorphic) {
+    return true;
+  }
+  else if constexpr (kind == cast_kind::down_cast_checked) {
+#ifdef NDEBUG
+    return !is_static_down_castable<To, From>::value;
+#else
+    return true;
+#endif
+  }
+  else if constexpr (kind == cast_kind::offset_pointer) {
+    return cast_uses_rtti<
+        typename offset_pointer_traits<std::remove_cv_t<To>>::pointer,
+        typename offset_pointer_traits<std::remove_cv_t<From>>::pointer,
+        Policy>();
+  }
+  else if constexpr (kind == cast_kind::aggregate) {
+    return aggregate_fields_use_rtti<std::remove_cv_t<To>,
+                                     std::remove_cv_t<From>, Policy>(
+        std::make_index_sequence<std::tuple_size_v<
+            aggregate_field_types_t<std::remove_cv_t<To>>>>{});
+  }
+  else {
+    return false;
+  }
+}
+
+template <typename To, typename From, typename Policy>
+constexpr bool cast_is_noexcept() noexcept
+{
+  constexpr cast_kind kind = auto_cast_impl<To, From, Policy>::kind();
+  if constexpr (kind == cast_kind::down_cast_polymorphic ||
+                kind == cast_kind::unicode || kind == cast_kind::invalid) {
+    return false;
+  }
+  else if constexpr (kind == cast_kind::standard_conversion) {
+    return noexcept(static_cast<To>(std::declval<From>()));
+  }
+  else if constexpr (kind == cast_kind::packed_pointer &&
+                     is_pointer_to_packed_conversion<To, From>()) {
+    using traits = packed_pointer_traits<std::remove_cv_t<To>>;
+    return noexcept(
+        traits::pack(std::declval<typename traits::element_type*>()));
+  }
+  else if constexpr (kind == cast_kind::offset_pointer) {
+    return cast_is_noexcept<
+        typename offset_pointer_traits<std::remove_cv_t<To>>::pointer,
+        typename offset_pointer_traits<std::remove_cv_t<From>>::pointer,
+        Policy>();
+  }
+  else if constexpr (kind == cast_kind::aggregate) {
+    return aggregate_fields_are_noexcept<std::remove_cv_t<To>,
+                                         std::remove_cv_t<From>, Policy>(
+        std::make_index_sequence<std::tuple_size_v<
+            aggregate_field_types_t<std::remove_cv_t<To>>>>{});
+  }
+  else {
+    return true;
+  }
+}
+
+// 只统计转换本身的分配；抛出异常时异常对象的分配由is_noexcept体现
+template <typename To, typename From, typename Policy>
+constexpr bool cast_may_allocate() noexcept
+{
+  constexpr cast_kind kind = auto_cast_impl<To, From, Policy>::kind();
+  if constexpr (kind == cast_kind::standard_conversion) {
+    return std::is_class_v<std::remove_cv_t<To>> &&
+           !std::is_trivially_copyable_v<std::remove_cv_t<To>>;
+  }
+  else if constexpr (kind == cast_kind::offset_pointer) {
+    return cast_may_allocate<
+        typename offset_pointer_traits<std::remove_cv_t<To>>::pointer,
+        typename offset_pointer_traits<std::remove_cv_t<From>>::pointer,
+        Policy>();
+  }
+  else if constexpr (kind == cast_kind::unicode) {
+    return true;
+  }
+  else if constexpr (kind == cast_kind::aggregate) {
+    // 结果记录本身的构造只在有非平凡字段时可能分配
+    return !std::is_trivially_default_constructible_v<std::remove_cv_t<To>> ||
+           aggregate_fields_may_allocate<std::remove_cv_t<To>,
+                                         std::remove_cv_t<From>, Policy>(
+               std::make_index_sequence<std::tuple_size_v<
+                   aggregate_field_types_t<std::remove_cv_t<To>>>>{});
+  }
+  else {
+    return false;
+  }
+}
+
+// 至多一次寄存器移动加一次偏移（含空指针检查）
+template <typename To, typename From, typename Policy>
+constexpr bool cast_is_zero_overhead() noexcept
+{
+  constexpr cast_kind kind = auto_cast_impl<To, From, Policy>::kind();
+  using to = std::remove_cv_t<To>;
+  using from = std::remove_cv_t<From>;
+  if constexpr (kind == cast_kind::same_type ||
+                kind == cast_kind::const_removal) {
+    return std::is_scalar_v<to>;
+  }
+  else if constexpr (kind == cast_kind::up_cast) {
+    // 虚基类需要读取虚表
+    return is_static_down_castable<From, To>::value;
+  }
+  else if constexpr (kind == cast_kind::down_cast_non_polymorphic ||
+                     kind == cast_kind::standard_pointer_integer ||
+                     kind == cast_kind::generic_pointer_integer ||
+                     kind == cast_kind::reinterpret) {
+    return true;
+  }
+  else if constexpr (kind == cast_kind::down_cast_checked) {
+    return !cast_uses_rtti<To, From, Policy>();
+  }
+  else if constexpr (kind == cast_kind::standard_conversion) {
+    if constexpr (std::is_pointer_v<to> &&
+                  (std::is_pointer_v<from> || std::is_null_pointer_v<from>)) {
+      return std::is_void_v<std::remove_pointer_t<to>> ||
+             std::is_same_v<std::remove_cv_t<std::remove_pointer_t<to>>,
+                            std::remove_cv_t<std::remove_pointer_t<from>>> ||
+             is_static_down_castable<From, To>::value;
+    }
+    else {
+      // 整数之间的扩展与截断；转换为bool需要比较，不算
+      return (std::is_integral_v<from> || std::is_enum_v<from>) &&
+             std::is_integral_v<to> && !std::is_same_v<to, bool>;
+    }
+  }
+  else if constexpr (kind == cast_kind::callable) {
+    // 无捕获lambda的函数指针是常量；function_ref要写入对象地址和调用入口
+    return std::is_pointer_v<to>;
+  }
+  else if constexpr (kind == cast_kind::offset_pointer) {
+    return cast_is_zero_overhead<
+        typename offset_pointer_traits<std::remove_cv_t<To>>::pointer,
+        typename offset_pointer_traits<std::remove_cv_t<From>>::pointer,
+        Policy>();
+  }
+  else {
+    return false;
+  }
+}
+
+// 转换特征：公开auto_cast_impl选择的转换种类及其开销
+template <typename To, typename From, typename Policy = default_policy>
+struct auto_cast_traits
+{
+  static constexpr cast_kind kind = auto_cast_impl<To, From, Policy>::kind();
+  static constexpr bool uses_rtti = cast_uses_rtti<To, From, Policy>();
+  static constexpr bool is_noexcept = cast_is_noexcept<To, From, Policy>();
+  static constexpr bool may_allocate = cast_may_allocate<To, From, Policy>();
+  static constexpr bool zero_overhead =
+      cast_is_zero_overhead<To, From, Policy>();
+};
+
+// 用户接口 - 带策略模板参数
+template <typename To, typename Policy = default_policy, typename From,
+          std::enable_if_t<!is_function_ref<To>::value, int> = 0>
+To auto_cast(From from)
+{
+  return auto_cast_impl<To, From, Policy>::cast(from);
+}
+
+// 转为function_ref时左值可调用对象按引用传入，function_ref引用调用方的对象；
+// 右值可调用对象会在编译时报错。只有auto_cast有这条左值路径，按值接收参数的
+// auto_cast_safe/auto_cast_strict/try_auto_cast等只接受函数指针
+template <typename To, typename Policy = default_policy, typename From,
+          std::enable_if_t<is_function_ref<To>::value, int> = 0>
+To auto_cast(From&& from)
+{
+  if constexpr (std::is_lvalue_reference_v<From> &&
+                std::is_class_v<std::remove_reference_t<From>>) {
+    static_assert(
+        satisfies_zero_overhead_policy<To, std::decay_t<From>, Policy>::value,
+        "auto_cast<>: This conversion is not guaranteed to be a "
+        "register move plus an offset add, which zero_overhead_policy "
+        "requires. Check auto_cast_traits<To, From, Policy>::kind.");
+    static_assert(is_valid_callable_conversion<To, From>(),
+                  "auto_cast<>: callable signature does not match "
+                  "function_ref<>");
+    return To(from);
+  }
+  else {
+    return auto_cast_impl<To, std::decay_t<From>, Policy>::cast(from);
+  }
+}
+
+// 便捷别名
+template <typename To, typename From>
+To auto_cast_safe(From from)
+{
+  return auto_cast_impl<To, From, default_policy>::cast(from);
+}
+
+template <typename To, typename From>
+To auto_cast_unsafe(From from)
+{
+  return auto_cast_impl<To, From, unsafe_policy>::cast(from);
+}
+
+template <typename To, typename From>
+To auto_cast_strict(From from)
+{
+  return auto_cast_impl<To, From, strict_policy>::cast(from);
+}
+
+template <typename To, typename From>
+To auto_cast_checked(From from)
+{
+  return auto_cast_impl<To, From, assert_checked_policy>::cast(from);
+}
+
+#if CPP_17
+// 运行时检查版本,返回std::optional
+template <typename To, typename From, typename Policy = default_policy>
+std::optional<To> try_auto_cast(From from) noexcept
+{
+  try {
+    return auto_cast_impl<To, From, Policy>::cast(from);
+  } catch (const std::bad_cast&) {
+    return std::nullopt;
+  } catch (...) {
+    return std::nullopt;
+  }
+}
+#else
+// 运行时检查版本,返回空对象
+template <typename To, typename From, typename Policy = default_policy>
+To try_auto_cast(From from) noexcept
+{
+  try {
+    return auto_cast_impl<To, From, Policy>::cast(from);
+  } catch (const std::bad_cast&) {
+    return To{};
+  } catch (...) {
+    return To{};
+  }
+}
+
+#endif
+
+#if CPP_17
+// 多目标向下转换：只识别一次动态类型，再按下标分派
+// 匹配结果：下标与已调整好的目标指针
+struct switch_cast_match
+{
+  std::size_t index;
+  void* target;
+};
+
+template <typename From, typename Indices, typename... Targets>
+struct switch_cast_table_impl;
+
+template <typename From, std::size_t... I, typename... Targets>
+struct switch_cast_table_impl<From, std::index_sequence<I...>, Targets...>
+{
+  using from_type = std::remove_pointer_t<From>;
+
+  static_assert(std::is_pointer_v<From>,
+                "auto_cast_switch<>: source must be a pointer");
+  static_assert(sizeof...(Targets) > 0,
+                "auto_cast_switch<>: at least one target type is required");
+  static_assert((std::is_pointer_v<Targets> && ...),
+                "auto_cast_switch<>: target types must be pointers");
+  static_assert(std::is_polymorphic_v<from_type>,
+                "auto_cast_switch<>: source type must be polymorphic");
+  static_assert((std::is_base_of_v<std::remove_cv_t<from_type>,
+                                   std::remove_cv_t<std::remove_pointer_t<
+                                       Targets>>> &&
+                 ...),
+                "auto_cast_switch<>: every target must derive from the "
+                "source type");
+
+  static constexpr std::size_t npos = sizeof...(Targets);
+
+  template <std::size_t N>
+  using target_t = std::tuple_element_t<N, std::tuple<Targets...>>;
+
+  using caster = void* (*)(From) noexcept;
+
+  // 动态类型已精确匹配时可以直接static_cast
+  template <std::size_t N>
+  static void* exact_cast(From from) noexcept
+  {
+    if constexpr (is_static_down_castable<target_t<N>, From>::value) {
+      return const_cast<void*>(static_cast<const volatile void*>(
+          static_cast<target_t<N>>(from)));
+    }
+    else {
+      return const_cast<void*>(static_cast<const volatile void*>(
+          dynamic_cast<target_t<N>>(from)));
+    }
+  }
+
+  template <std::size_t N>
+  static void* checked_cast(From from) noexcept
+  {
+    return const_cast<void*>(static_cast<const volatile void*>(
+        dynamic_cast<target_t<N>>(from)));
+  }
+
+  template <std::size_t N>
+  using target_object_t = std::remove_cv_t<std::remove_pointer_t<target_t<N>>>;
+
+  // 动态类型恰为target_t<N>时，第一个可能接收它的目标（是它自身或它的基类）
+  template <std::size_t N, std::size_t J = 0>
+  static constexpr std::size_t first_match_of() noexcept
+  {
+    if constexpr (std::is_base_of_v<target_object_t<J>, target_object_t<N>>) {
+      return J;
+    }
+    else {
+      return first_match_of<N, J + 1>();
+    }
+  }
+
+  // 声明在前的基类目标优先，此时需要按该目标做一次dynamic_cast；
+  // 该基类有歧义时能否匹配取决于传入的子对象，返回nullptr交给逐个dynamic_cast
+  template <std::size_t N>
+  static constexpr caster exact_caster_of() noexcept
+  {
+    constexpr std::size_t first = first_match_of<N>();
+    if constexpr (first == N) {
+      return &exact_cast<N>;
+    }
+    else if constexpr (std::is_convertible_v<target_object_t<N>*,
+                                             target_object_t<first>*>) {
+      return &checked_cast<first>;
+    }
+    else {
+      return nullptr;
+    }
+  }
+
+  // 预先计算的类型->下标表
+  inline static const std::type_info* const types[] = {
+      &typeid(std::remove_cv_t<std::remove_pointer_t<Targets>>)...};
+  static constexpr std::size_t exact_indices[] = {first_match_of<I>()...};
+  static constexpr caster exact_casters[] = {exact_caster_of<I>()...};
+  static constexpr caster checked_casters[] = {&checked_cast<I>...};
+
+  // 未登记的派生类型：记住解析出的下标（包括未匹配），下次最多一次dynamic_cast。
+  // 源类型在动态类型中重复出现时，dynamic_cast的结果还取决于传入的是哪个子对象，
+  // 因此以动态类型加上源子对象在完整对象中的偏移作为键
+  struct cache_entry
+  {
+    const std::type_info* type;
+    std::ptrdiff_t offset;
+    std::size_t index;
+  };
+  static constexpr std::size_t cache_size = 16;
+  inline static thread_local cache_entry cache[cache_size] = {};
+
+  static cache_entry& cache_slot(const std::type_info& type,
+                                 std::ptrdiff_t offset) noexcept
+  {
+    return cache[((reinterpret_cast<std::uintptr_t>(&type) >> 4) ^
+                  static_cast<std::uintptr_t>(offset)) %
+                 cache_size];
+  }
+
+  // 源子对象相对完整对象起始地址的偏移（只读取虚表中的offset-to-top）
+  static std::ptrdiff_t subobject_offset(From from) noexcept
+  {
+    return static_cast<const volatile char*>(
+               static_cast<const volatile void*>(from)) -
+           static_cast<const volatile char*>(
+               dynamic_cast<const volatile void*>(from));
+  }
+
+  static switch_cast_match resolve(From from) noexcept
+  {
+    if (!from) {
+      return {npos, nullptr};
+    }
+    const std::type_info& dynamic_type = typeid(*from);
+    for (std::size_t i = 0; i < npos; ++i) {
+      if (*types[i] == dynamic_type) {
+        if (exact_casters[i]) {
+          return {exact_indices[i], exact_casters[i](from)};
+        }
+        break;
+      }
+    }
+    const std::ptrdiff_t offset = subobject_offset(from);
+    cache_entry& slot = cache_slot(dynamic_type, offset);
+    if (slot.type == &dynamic_type && slot.offset == offset) {
+      if (slot.index == npos) {
+        return {npos, nullptr};
+      }
+      // 缓存只是提示：转换失败时重新逐个解析
+      if (void* target = checked_casters[slot.index](from)) {
+        return {slot.index, target};
+      }
+    }
+    // 回退：按声明顺序逐个dynamic_cast，第一个成功的目标胜出
+    for (std::size_t i = 0; i < npos; ++i) {
+      if (void* target = checked_casters[i](from)) {
+        slot = {&dynamic_type, offset, i};
+        return {i, target};
+      }
+    }
+    slot = {&dynamic_type, offset, npos};
+    return {npos, nullptr};
+  }
+};
+
+template <typename From, typename... Targets>
+using switch_cast_table =
+    switch_cast_table_impl<From, std::index_sequence_for<Targets...>,
+                           Targets...>;
+
+// 处理函数的公共返回类型，第N+1个处理函数（可选）接收未匹配的源指针
+template <typename From, typename TargetTuple, typename HandlerTuple,
+          typename Indices>
+struct switch_cast_result;
+
+template <typename From, typename... Targets, typename... Handlers,
+          std::size_t... I>
+struct switch_cast_result<From, std::tuple<Targets...>,
+                          std::tuple<Handlers...>, std::index_sequence<I...>>
+{
+private:
+  using handler_tuple = std::tuple<Handlers...>;
+  static constexpr bool has_fallback =
+      sizeof...(Handlers) == sizeof...(Targets) + 1;
+
+  template <bool Fallback, typename = void>
+  struct fallback_result
+  {
+    using type = std::common_type_t<
+        std::invoke_result_t<std::tuple_element_t<I, handler_tuple>,
+                             Targets>...>;
+  };
+
+  template <typename Dummy>
+  struct fallback_result<true, Dummy>
+  {
+    using type = std::common_type_t<
+        std::invoke_result_t<std::tuple_element_t<I, handler_tuple>,
+                             Targets>...,
+        std::invoke_result_t<
+            std::tuple_element_t<sizeof...(Targets), handler_tuple>, From>>;
+  };
+
+public:
+  static_assert(sizeof...(Handlers) == sizeof...(Targets) || has_fallback,
+                "auto_cast_switch<>: expected one handler per target type, "
+                "optionally followed by a fallback handler");
+  using type = typename fallback_result<has_fallback>::type;
+  static_assert(has_fallback || std::is_void_v<type> ||
+                    (!std::is_reference_v<type> &&
+                     std::is_default_constructible_v<type>),
+                "auto_cast_switch<>: handlers return a reference or a type "
+                "without a default constructor, so a fallback handler is "
+                "required for the unmatched case");
+};
+
+template <typename R, std::size_t N, typename Table, typename From,
+          typename HandlerTuple>
+R switch_cast_invoke(From from, void* target, HandlerTuple& handlers)
+{
+  if constexpr (N < Table::npos) {
+    using target_type = typename Table::template target_t<N>;
+    return std::invoke(std::get<N>(handlers), static_cast<target_type>(target));
+  }
+  else if constexpr (std::tuple_size_v<HandlerTuple> > Table::npos) {
+    return std::invoke(std::get<Table::npos>(handlers), from);
+  }
+  else {
+    return R();
+  }
+}
+
+template <typename R, typename Table, typename From, typename HandlerTuple,
+          std::size_t... N>
+R switch_cast_dispatch(From from, HandlerTuple& handlers,
+                       std::index_sequence<N...>)
+{
+  using thunk = R (*)(From, void*, HandlerTuple&);
+  // 跳转表：最后一项对应未匹配的情况
+  static constexpr thunk thunks[] = {
+      &switch_cast_invoke<R, N, Table, From, HandlerTuple>...};
+  const switch_cast_match match = Table::resolve(from);
+  return thunks[match.index](from, match.target, handlers);
+}
+
+// 返回匹配的目标类型下标，未匹配时返回sizeof...(Targets)
+template <typename... Targets, typename From>
+std::size_t auto_cast_index(From from) noexcept
+{
+  return switch_cast_table<From, Targets...>::resolve(from).index;
+}
+
+// 依次为每个目标类型提供一个处理函数，可额外提供一个处理未匹配情况的函数
+template <typename... Targets, typename From, typename... Handlers>
+decltype(auto) auto_cast_switch(From from, Handlers&&... handlers)
+{
+  using table = switch_cast_table<From, Targets...>;
+  using result = typename switch_cast_result<
+      From, std::tuple<Targets...>, std::tuple<Handlers...>,
+      std::index_sequence_for<Targets...>>::type;
+  auto handler_tuple = std::forward_as_tuple(std::forward<Handlers>(handlers)...);
+  return switch_cast_dispatch<result, table>(
+      from, handler_tuple, std::make_index_sequence<table::npos + 1>{});
+}
+#endif
+
+// 运行时转换注册表：源/目标类型只在运行时以std::type_index给出时使用（反序列化、插件）
+// 注册时实例化auto_cast_impl，策略检查仍在编译时完成；查找无锁，注册加锁
+class conversion_registry
+{
+public:
+  // 转换失败（如多态向下转换的动态类型不符）时返回false
+  using converter = bool (*)(const void* from, void* to);
+
+  explicit conversion_registry(std::size_t capacity = 256)
+      : id_(next_id()),
+        mask_(round_up_capacity(capacity) - 1),
+        slots_(new slot[mask_ + 1])
+  {
+  }
+
+  conversion_registry(const conversion_registry&) = delete;
+  conversion_registry& operator=(const conversion_registry&) = delete;
+
+  // 注册From到To的转换；重复注册会替换已有的转换，表满时返回false
+  template <typename To, typename From, typename Policy = default_policy>
+  bool add()
+  {
+    return insert(typeid(From), typeid(To), &convert_thunk<To, From, Policy>);
+  }
+
+  converter find(std::type_index from, std::type_index to) const noexcept
+  {
+    // 每个线程缓存最近一次命中，重复的类型对只需比较一次
+    thread_local lookup_cache cache{};
+    const std::uint64_t generation =
+        generation_.load(std::memory_order_acquire);
+    if (cache.owner == id_ && cache.generation == generation &&
+        std::type_index(*cache.from) == from &&
+        std::type_index(*cache.to) == to) {
+      return cache.fn;
+    }
+    const slot* found = probe(from, to, hash_of(from, to));
+    if (!found) {
+      return nullptr;
+    }
+    const converter fn = found->fn.load(std::memory_order_acquire);
+    cache = {id_, generation, found->from, found->to, fn};
+    return fn;
+  }
+
+  // to指向一个已构造的To对象，转换结果赋值给它；未注册或转换失败时返回false。
+  // 转换失败指库报告的转换错误（std::bad_cast、unicode_error），内存不足等仍会抛出
+  bool convert(std::type_index from, std::type_index to, const void* source,
+               void* target) const
+  {
+    const converter fn = find(from, to);
+    return fn && fn(source, target);
+  }
+
+  std::size_t size() const noexcept
+  {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct slot
+  {
+    std::atomic<converter> fn{nullptr};
+    const std::type_info* from = nullptr;
+    const std::type_info* to = nullptr;
+    std::size_t hash = 0;
+  };
+
+  // 用实例编号而不是地址识别注册表，避免新实例复用旧地址时命中过期缓存
+  struct lookup_cache
+  {
+    std::uint64_t owner;
+    std::uint64_t generation;
+    const std::type_info* from;
+    const std::type_info* to;
+    converter fn;
+  };
+
+  template <typename To, typename From, typename Policy>
+  static bool convert_thunk(const void* from, void* to)
+  {
+    try {
+      *static_cast<To*>(to) =
+          auto_cast_impl<To, From, Policy>::cast(*static_cast<const From*>(from));
+      return true;
+    } catch (const std::bad_cast&) {
+      return false;
+    } catch (const unicode_error&) {
+      return false;
+    }
+  }
+
+  static std::uint64_t next_id() noexcept
+  {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  static std::size_t round_up_capacity(std::size_t capacity) noexcept
+  {
+    std::size_t result = 16;
+    while (result < capacity) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  static std::size_t hash_of(std::type_index from, std::type_index to) noexcept
+  {
+    const std::size_t seed = from.hash_code();
+    return seed ^ (to.hash_code() + 0x9e3779b97f4a7c15ull + (seed << 6) +
+                   (seed >> 2));
+  }
+
+  // 线性探测；槽位发布后不再移动，读者遇到空槽即可结束
+  const slot* probe(std::type_index from, std::type_index to,
+                    std::size_t hash) const noexcept
+  {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+      const slot& candidate = slots_[(hash + i) & mask_];
+      if (!candidate.fn.load(std::memory_order_acquire)) {
+        return nullptr;
+      }
+      if (candidate.hash == hash && from == std::type_index(*candidate.from) &&
+          to == std::type_index(*candidate.to)) {
+        return &candidate;
+      }
+    }
+    return nullptr;
+  }
+
+  bool insert(const std::type_info& from, const std::type_info& to,
+              converter fn)
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const std::size_t hash = hash_of(from, to);
+    if (const slot* existing = probe(from, to, hash)) {
+      const_cast<slot*>(existing)->fn.store(fn, std::memory_order_release);
+      generation_.fetch_add(1, std::memory_order_release);
+      return true;
+    }
+    // 保持至少四分之一空槽，保证探测很快结束
+    if ((size() + 1) * 4 > (mask_ + 1) * 3) {
+      return false;
+    }
+    for (std::size_t i = 0;; ++i) {
+      slot& candidate = slots_[(hash + i) & mask_];
+      if (!candidate.fn.load(std::memory_order_relaxed)) {
+        candidate.from = &from;
+        candidate.to = &to;
+        candidate.hash = hash;
+        candidate.fn.store(fn, std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+
+  const std::uint64_t id_;
+  const std::size_t mask_;
+  std::unique_ptr<slot[]> slots_;
+  std::atomic<std::size_t> size_{0};
+  std::atomic<std::uint64_t> generation_{0};
+  std::mutex write_mutex_;
+};
+
+// 进程内共享的默认注册表
+inline conversion_registry& global_conversion_registry()
+{
+  static conversion_registry registry;
+  return registry;
+}
+
+// 半精度批量转换内核，按CPU特性在首次使用时选择
+struct half_precision_kernels
+{
+  void (*float_to_float16)(const float*, float16*, std::size_t) noexcept;
+  void (*float16_to_float)(const float16*, float*, std::size_t) noexcept;
+  void (*float_to_bfloat16)(const float*, bfloat16*, std::size_t) noexcept;
+  void (*bfloat16_to_float)(const bfloat16*, float*, std::size_t) noexcept;
+};
+
+inline void float_to_float16_portable(const float* from, float16* to,
+                                      std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    to[i] = float16{float_to_float16_bits(from[i])};
+  }
+}
+
+inline void float16_to_float_portable(const float16* from, float* to,
+                                      std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    to[i] = float16_bits_to_float(from[i].bits);
+  }
+}
+
+inline void float_to_bfloat16_portable(const float* from, bfloat16* to,
+                                       std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    to[i] = bfloat16{float_to_bfloat16_bits(from[i])};
+  }
+}
+
+inline void bfloat16_to_float_portable(const bfloat16* from, float* to,
+                                       std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    to[i] = bfloat16_bits_to_float(from[i].bits);
+  }
+}
+
+#ifdef AUTO_CAST_X86_SIMD
+// AVX-512的非掩码内建函数以未定义的寄存器作为合并源，GCC会报告可能未初始化；
+// 这里统一使用全部通道有效的maskz形式，生成的指令相同
+constexpr __mmask16 all_lanes_mask16 = 0xffff;
+
+__attribute__((target("avx,f16c"))) inline void float_to_float16_f16c(
+    const float* from, float16* to, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i half =
+        _mm256_cvtps_ph(_mm256_loadu_ps(from + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i), half);
+  }
+  float_to_float16_portable(from + i, to + i, count - i);
+}
+
+__attribute__((target("avx,f16c"))) inline void float16_to_float_f16c(
+    const float16* from, float* to, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i half =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+    _mm256_storeu_ps(to + i, _mm256_cvtph_ps(half));
+  }
+  float16_to_float_portable(from + i, to + i, count - i);
+}
+
+__attribute__((target("avx512f"))) inline void float_to_float16_avx512(
+    const float* from, float16* to, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i half = _mm512_maskz_cvtps_ph(
+        all_lanes_mask16, _mm512_loadu_ps(from + i),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i), half);
+  }
+  float_to_float16_portable(from + i, to + i, count - i);
+}
+
+__attribute__((target("avx512f"))) inline void float16_to_float_avx512(
+    const float16* from, float* to, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i half =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+    _mm512_storeu_ps(to + i, _mm512_maskz_cvtph_ps(all_lanes_mask16, half));
+  }
+  float16_to_float_portable(from + i, to + i, count - i);
+}
+
+// 与float_to_bfloat16_bits逐位一致的整数实现
+__attribute__((target("avx2"))) inline void float_to_bfloat16_avx2(
+    const float* from, bfloat16* to, std::size_t count) noexcept
+{
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i bias = _mm256_set1_epi32(0x7fff);
+  const __m256i abs_mask = _mm256_set1_epi32(0x7fffffff);
+  const __m256i infinity = _mm256_set1_epi32(0x7f800000);
+  const __m256i quiet = _mm256_set1_epi32(0x40);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(from + i));
+    const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), one);
+    const __m256i rounded = _mm256_srli_epi32(
+        _mm256_add_epi32(bits, _mm256_add_epi32(bias, lsb)), 16);
+    const __m256i nan = _mm256_or_si256(_mm256_srli_epi32(bits, 16), quiet);
+    const __m256i is_nan =
+        _mm256_cmpgt_epi32(_mm256_and_si256(bits, abs_mask), infinity);
+    const __m256i result = _mm256_blendv_epi8(rounded, nan, is_nan);
+    const __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(result, result), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i),
+                     _mm256_castsi256_si128(packed));
+  }
+  float_to_bfloat16_portable(from + i, to + i, count - i);
+}
+
+__attribute__((target("avx2"))) inline void bfloat16_to_float_avx2(
+    const bfloat16* from, float* to, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i half =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+    const __m256i bits = _mm256_slli_epi32(_mm256_cvtepu16_epi32(half), 16);
+    _mm256_storeu_ps(to + i, _mm256_castsi256_ps(bits));
+  }
+  bfloat16_to_float_portable(from + i, to + i, count - i);
+}
+
+__attribute__((target("avx512f,avx512bf16"))) inline void
+float_to_bfloat16_avx512(const float* from, bfloat16* to,
+                         std::size_t count) noexcept
+{
+  // 硬件指令把非规格化输入当作零，含非规格化数的块交给标量实现
+  const __m512i abs_mask = _mm512_set1_epi32(0x7fffffff);
+  const __m512i one = _mm512_set1_epi32(1);
+  // magnitude - 1 <= 0x7ffffe 即 magnitude 位于 [1, 0x7fffff]
+  const __m512i subnormal_limit = _mm512_set1_epi32(0x007ffffe);
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m512 value = _mm512_loadu_ps(from + i);
+    const __m512i magnitude =
+        _mm512_and_si512(_mm512_castps_si512(value), abs_mask);
+    if (_mm512_cmple_epu32_mask(_mm512_sub_epi32(magnitude, one),
+                                subnormal_limit) == 0) {
+      const __m256bh half = _mm512_cvtneps_pbh(value);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i),
+                          reinterpret_cast<const __m256i&>(half));
+    }
+    else {
+      float_to_bfloat16_portable(from + i, to + i, 16);
+    }
+  }
+  float_to_bfloat16_portable(from + i, to + i, count - i);
+}
+
+__attribute__((target("avx512f"))) inline void bfloat16_to_float_avx512(
+    const bfloat16* from, float* to, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i half =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+    const __m512i bits = _mm512_maskz_slli_epi32(
+        all_lanes_mask16, _mm512_maskz_cvtepu16_epi32(all_lanes_mask16, half),
+        16);
+    _mm512_storeu_ps(to + i, _mm512_castsi512_ps(bits));
+  }
+  bfloat16_to_float_portable(from + i, to + i, count - i);
+}
+#endif
+
+inline const half_precision_kernels& select_half_precision_kernels() noexcept
+{
+  static const half_precision_kernels kernels = [] {
+    half_precision_kernels selected{
+        &float_to_float16_portable, &float16_to_float_portable,
+        &float_to_bfloat16_portable, &bfloat16_to_float_portable};
+#ifdef AUTO_CAST_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      selected.float_to_bfloat16 = &float_to_bfloat16_avx2;
+      selected.bfloat16_to_float = &bfloat16_to_float_avx2;
+    }
+    // F16C内核使用256位寄存器，还需要AVX（包括操作系统保存YMM状态）
+    if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c")) {
+      selected.float_to_float16 = &float_to_float16_f16c;
+      selected.float16_to_float = &float16_to_float_f16c;
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+      selected.float_to_float16 = &float_to_float16_avx512;
+      selected.float16_to_float = &float16_to_float_avx512;
+      selected.bfloat16_to_float = &bfloat16_to_float_avx512;
+      if (__builtin_cpu_supports("avx512bf16")) {
+        selected.float_to_bfloat16 = &float_to_bfloat16_avx512;
+      }
+    }
+#endif
+    return selected;
+  }();
+  return kernels;
+}
+
+// 批量转换：float与半精度之间使用SIMD内核，其余类型逐个按策略auto_cast
+template <typename To, typename Policy = default_policy, typename From>
+void auto_cast_span(const From* from, To* to, std::size_t count)
+{
+  // SIMD内核和整段复制不经过auto_cast_impl，策略检查要在这里完成
+  static_assert(satisfies_zero_overhead_policy<To, From, Policy>::value,
+                "auto_cast_span<>: This conversion is not guaranteed to be a "
+                "register move plus an offset add, which zero_overhead_policy "
+                "requires. Check auto_cast_traits<To, From, Policy>::kind.");
+  if constexpr (std::is_same_v<From, float> && std::is_same_v<To, float16>) {
+    select_half_precision_kernels().float_to_float16(from, to, count);
+  }
+  else if constexpr (std::is_same_v<From, float16> &&
+                     std::is_same_v<To, float>) {
+    select_half_precision_kernels().float16_to_float(from, to, count);
+  }
+  else if constexpr (std::is_same_v<From, float> &&
+                     std::is_same_v<To, bfloat16>) {
+    select_half_precision_kernels().float_to_bfloat16(from, to, count);
+  }
+  else if constexpr (std::is_same_v<From, bfloat16> &&
+                     std::is_same_v<To, float>) {
+    select_half_precision_kernels().bfloat16_to_float(from, to, count);
+  }
+  else if constexpr (is_aggregate_conversion<To, From>()) {
+    // 转换计划只对聚合体实例化，不能与上面的条件合并成一个&&
+    using plan =
+        aggregate_conversion_plan<std::remove_cv_t<To>, std::remove_cv_t<From>>;
+    if constexpr (plan::is_bitwise_copy()) {
+      // 字段布局完全一致的记录整段复制
+      if (count != 0 && plan::layout_matches(to[0], from[0])) {
+        std::memcpy(to, from, count * sizeof(To));
+        return;
+      }
+    }
+    // 直接写入目标记录，避免经由返回值的临时对象
+    for (std::size_t i = 0; i < count; ++i) {
+      aggregate_cast_into<Policy>(from[i], to[i]);
+    }
+  }
+  else {
+    for (std::size_t i = 0; i < count; ++i) {
+      to[i] = auto_cast_impl<To, From, Policy>::cast(from[i]);
+    }
+  }
+}
+
+template <typename Fields>
+struct soa_column_storage;
+
+template <typename... Fields>
+struct soa_column_storage<std::tuple<Fields...>>
+{
+  using type = std::tuple<std::unique_ptr<Fields[]>...>;
+};
+
+// 数组结构容器：Record的每个字段单独存成一列，只能移动不能复制
+template <typename Record>
+class struct_of_arrays
+{
+public:
+  using record_type = Record;
+  using field_types = aggregate_field_types_t<Record>;
+  static constexpr std::size_t field_count = std::tuple_size_v<field_types>;
+
+  template <std::size_t I>
+  using field_type = std::tuple_element_t<I, field_types>;
+
+  explicit struct_of_arrays(std::size_t size = 0) { resize(size); }
+
+  std::size_t size() const noexcept { return size_; }
+
+  // 重新分配所有列，保留前min(size(), size)行；行数不变时不分配
+  void resize(std::size_t size)
+  {
+    if (size == size_) {
+      return;
+    }
+    resize_columns(size, std::make_index_sequence<field_count>{});
+    size_ = size;
+  }
+
+  template <std::size_t I>
+  field_type<I>* column() noexcept
+  {
+    return std::get<I>(columns_).get();
+  }
+
+  template <std::size_t I>
+  const field_type<I>* column() const noexcept
+  {
+    return std::get<I>(columns_).get();
+  }
+
+private:
+  template <std::size_t... I>
+  void resize_columns(std::size_t size, std::index_sequence<I...>)
+  {
+    (resize_column<I>(size), ...);
+  }
+
+  template <std::size_t I>
+  void resize_column(std::size_t size)
+  {
+    std::unique_ptr<field_type<I>[]> column(new field_type<I>[size]());
+    std::copy(column_data<I>(), column_data<I>() + std::min(size, size_),
+              column.get());
+    std::get<I>(columns_) = std::move(column);
+  }
+
+  template <std::size_t I>
+  field_type<I>* column_data() noexcept
+  {
+    return std::get<I>(columns_).get();
+  }
+
+  typename soa_column_storage<field_types>::type columns_;
+  std::size_t size_ = 0;
 };
 
-// Step 4: תǶ̬
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 4>
+// 4字节字段的转置内核：行是记录，列是字段，columns[f]指向第f列
+struct soa_transpose_kernels
 {
-  using type = typename std::conditional<
-      is_down_cast_impl<To, From>() &&
-          !std::is_polymorphic<remove_cv_ptr_t<From>>::value &&
-          Policy::allow_non_polymorphic_downcast,
-      down_cast_non_polymorphic_tag,
-      typename get_cast_tag<To, From, Policy, 5>::type>::type;
+  void (*rows_to_columns)(const void* rows, std::size_t count,
+                          std::size_t fields, void* const* columns) noexcept;
+  void (*columns_to_rows)(const void* const* columns, std::size_t count,
+                          std::size_t fields, void* rows) noexcept;
 };
 
-// Step 5: ׼ָ?ת
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 5>
+// 每块记录的字节数，块内的行在各字段之间保持在L1中
+static constexpr std::size_t soa_block_bytes = 16 * 1024;
+
+inline void rows_to_columns_portable(const void* rows, std::size_t count,
+                                     std::size_t fields,
+                                     void* const* columns) noexcept
 {
-private:
-  template <typename T>
-  static constexpr bool is_standard_int()
-  {
-    return std::is_same<T, std::intptr_t>::value ||
-           std::is_same<T, std::uintptr_t>::value;
+  const auto* source = static_cast<const unsigned char*>(rows);
+  const std::size_t block = std::max<std::size_t>(
+      1, soa_block_bytes / (fields * sizeof(std::uint32_t)));
+  for (std::size_t begin = 0; begin < count; begin += block) {
+    const std::size_t end = std::min(count, begin + block);
+    for (std::size_t f = 0; f < fields; ++f) {
+      auto* column = static_cast<unsigned char*>(columns[f]);
+      for (std::size_t i = begin; i < end; ++i) {
+        std::memcpy(column + i * sizeof(std::uint32_t),
+                    source + (i * fields + f) * sizeof(std::uint32_t),
+                    sizeof(std::uint32_t));
+      }
+    }
   }
+}
 
-public:
-  using type = std::conditional_t<
-      ((std::is_pointer<From>::value && is_standard_int<To>()) ||
-       (is_standard_int<From>() && std::is_pointer<To>::value)) &&
-          Policy::allow_standard_pointer_integer_cast,
-      standard_pointer_integer_tag,
-      typename get_cast_tag<To, From, Policy, 6>::type>;
-};
+inline void columns_to_rows_portable(const void* const* columns,
+                                     std::size_t count, std::size_t fields,
+                                     void* rows) noexcept
+{
+  auto* target = static_cast<unsigned char*>(rows);
+  const std::size_t block = std::max<std::size_t>(
+      1, soa_block_bytes / (fields * sizeof(std::uint32_t)));
+  for (std::size_t begin = 0; begin < count; begin += block) {
+    const std::size_t end = std::min(count, begin + block);
+    for (std::size_t f = 0; f < fields; ++f) {
+      const auto* column = static_cast<const unsigned char*>(columns[f]);
+      for (std::size_t i = begin; i < end; ++i) {
+        std::memcpy(target + (i * fields + f) * sizeof(std::uint32_t),
+                    column + i * sizeof(std::uint32_t), sizeof(std::uint32_t));
+      }
+    }
+  }
+}
 
-// Step 6: ָͨ?ת
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 6>
+#ifdef AUTO_CAST_X86_SIMD
+// 8x8转置，行列两个方向共用
+__attribute__((target("avx2"))) inline void transpose_8x8_avx2(
+    __m256 (&v)[8]) noexcept
 {
-  using type = std::conditional_t<
-      ((std::is_pointer<From>::value && std::is_integral<To>::value) ||
-       (std::is_integral<From>::value && std::is_pointer<To>::value)) &&
-          Policy::allow_reinterpret,
-      generic_pointer_integer_tag,
-      typename get_cast_tag<To, From, Policy, 7>::type>;
-};
+  const __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+  const __m256 t1 = _mm256_unpackhi_ps(v[0], v[1]);
+  const __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]);
+  const __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+  const __m256 t4 = _mm256_unpacklo_ps(v[4], v[5]);
+  const __m256 t5 = _mm256_unpackhi_ps(v[4], v[5]);
+  const __m256 t6 = _mm256_unpacklo_ps(v[6], v[7]);
+  const __m256 t7 = _mm256_unpackhi_ps(v[6], v[7]);
+  const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  v[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+  v[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+  v[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+  v[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+  v[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+  v[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+  v[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+  v[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
 
-// Step 7: ׼ת
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 7>
+// 字段按8个一组用8x8转置，剩余4个一组用4x4转置，最后不足4个的字段逐个复制
+__attribute__((target("avx2"))) inline void rows_to_columns_avx2(
+    const void* rows, std::size_t count, std::size_t fields,
+    void* const* columns) noexcept
 {
-  using type =
-      std::conditional_t<std::is_convertible<From, To>::value,
-                         standard_conversion_tag,
-                         typename get_cast_tag<To, From, Policy, 8>::type>;
-};
+  const auto* source = static_cast<const float*>(rows);
+  const std::size_t block = std::max<std::size_t>(
+      8, soa_block_bytes / (fields * sizeof(float)) / 8 * 8);
+  const std::size_t vector_count = count / 8 * 8;
+  for (std::size_t begin = 0; begin < vector_count; begin += block) {
+    const std::size_t end = std::min(vector_count, begin + block);
+    std::size_t f = 0;
+    for (; f + 8 <= fields; f += 8) {
+      for (std::size_t i = begin; i < end; i += 8) {
+        __m256 v[8];
+        for (int r = 0; r < 8; ++r) {
+          v[r] = _mm256_loadu_ps(source + (i + r) * fields + f);
+        }
+        transpose_8x8_avx2(v);
+        for (int c = 0; c < 8; ++c) {
+          _mm256_storeu_ps(static_cast<float*>(columns[f + c]) + i, v[c]);
+        }
+      }
+    }
+    if (f + 4 <= fields) {
+      for (std::size_t i = begin; i < end; i += 4) {
+        __m128 r0 = _mm_loadu_ps(source + (i + 0) * fields + f);
+        __m128 r1 = _mm_loadu_ps(source + (i + 1) * fields + f);
+        __m128 r2 = _mm_loadu_ps(source + (i + 2) * fields + f);
+        __m128 r3 = _mm_loadu_ps(source + (i + 3) * fields + f);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(static_cast<float*>(columns[f + 0]) + i, r0);
+        _mm_storeu_ps(static_cast<float*>(columns[f + 1]) + i, r1);
+        _mm_storeu_ps(static_cast<float*>(columns[f + 2]) + i, r2);
+        _mm_storeu_ps(static_cast<float*>(columns[f + 3]) + i, r3);
+      }
+      f += 4;
+    }
+    for (; f < fields; ++f) {
+      auto* column = static_cast<float*>(columns[f]);
+      for (std::size_t i = begin; i < end; ++i) {
+        column[i] = source[i * fields + f];
+      }
+    }
+  }
 
-// Step 8: 鲻ָ͵reinterpret_cast
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 8>
+  // 不足8条的尾部记录
+  void* tail_columns[16];
+  for (std::size_t f = 0; f < fields; ++f) {
+    tail_columns[f] = static_cast<float*>(columns[f]) + vector_count;
+  }
+  rows_to_columns_portable(source + vector_count * fields, count - vector_count,
+                           fields, tail_columns);
+}
+
+__attribute__((target("avx2"))) inline void columns_to_rows_avx2(
+    const void* const* columns, std::size_t count, std::size_t fields,
+    void* rows) noexcept
+{
+  auto* target = static_cast<float*>(rows);
+  const std::size_t block = std::max<std::size_t>(
+      8, soa_block_bytes / (fields * sizeof(float)) / 8 * 8);
+  const std::size_t vector_count = count / 8 * 8;
+  for (std::size_t begin = 0; begin < vector_count; begin += block) {
+    const std::size_t end = std::min(vector_count, begin + block);
+    std::size_t f = 0;
+    for (; f + 8 <= fields; f += 8) {
+      for (std::size_t i = begin; i < end; i += 8) {
+        __m256 v[8];
+        for (int c = 0; c < 8; ++c) {
+          v[c] = _mm256_loadu_ps(static_cast<const float*>(columns[f + c]) + i);
+        }
+        transpose_8x8_avx2(v);
+        for (int r = 0; r < 8; ++r) {
+          _mm256_storeu_ps(target + (i + r) * fields + f, v[r]);
+        }
+      }
+    }
+    if (f + 4 <= fields) {
+      for (std::size_t i = begin; i < end; i += 4) {
+        __m128 c0 = _mm_loadu_ps(static_cast<const float*>(columns[f + 0]) + i);
+        __m128 c1 = _mm_loadu_ps(static_cast<const float*>(columns[f + 1]) + i);
+        __m128 c2 = _mm_loadu_ps(static_cast<const float*>(columns[f + 2]) + i);
+        __m128 c3 = _mm_loadu_ps(static_cast<const float*>(columns[f + 3]) + i);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(target + (i + 0) * fields + f, c0);
+        _mm_storeu_ps(target + (i + 1) * fields + f, c1);
+        _mm_storeu_ps(target + (i + 2) * fields + f, c2);
+        _mm_storeu_ps(target + (i + 3) * fields + f, c3);
+      }
+      f += 4;
+    }
+    for (; f < fields; ++f) {
+      const auto* column = static_cast<const float*>(columns[f]);
+      for (std::size_t i = begin; i < end; ++i) {
+        target[i * fields + f] = column[i];
+      }
+    }
+  }
+
+  const void* tail_columns[16];
+  for (std::size_t f = 0; f < fields; ++f) {
+    tail_columns[f] = static_cast<const float*>(columns[f]) + vector_count;
+  }
+  columns_to_rows_portable(tail_columns, count - vector_count, fields,
+                           target + vector_count * fields);
+}
+#endif
+
+inline const soa_transpose_kernels& select_soa_transpose_kernels() noexcept
+{
+  static const soa_transpose_kernels kernels = [] {
+    soa_transpose_kernels selected{&rows_to_columns_portable,
+                                   &columns_to_rows_portable};
+#ifdef AUTO_CAST_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      selected.rows_to_columns = &rows_to_columns_avx2;
+      selected.columns_to_rows = &columns_to_rows_avx2;
+    }
+#endif
+    return selected;
+  }();
+  return kernels;
+}
+
+// 纯转置：两边字段类型逐个相同、都是4字节可平凡复制类型，且记录没有填充
+template <typename From, typename To,
+          typename FromFields = aggregate_field_types_t<From>,
+          typename ToFields = aggregate_field_types_t<To>>
+struct is_soa_transpose_only : std::false_type
 {
-  using type = std::conditional_t<
-      std::is_pointer<To>::value && std::is_pointer<From>::value &&
-          Policy::allow_reinterpret,
-      reinterpret_cast_tag, typename get_cast_tag<To, From, Policy, 9>::type>;
 };
 
-// Step 9: ޷תݹֹ
-template <typename To, typename From, typename Policy>
-struct get_cast_tag<To, From, Policy, 9>
+template <typename From, typename To, typename... Fields>
+struct is_soa_transpose_only<From, To, std::tuple<Fields...>,
+                             std::tuple<Fields...>>
+    : std::bool_constant<((sizeof(Fields) == 4 &&
+                           std::is_trivially_copyable_v<Fields>) &&
+                          ...) &&
+                         sizeof(From) == 4 * sizeof...(Fields) &&
+                         sizeof(To) == 4 * sizeof...(Fields)>
 {
-  using type = invalid_cast_tag;
 };
 
-// תʵֺ
-template <typename To, typename From>
-To cast_impl(From from, same_type_tag)
+template <typename Record, typename Pointer, std::size_t... I>
+void soa_column_pointers(Record& soa, Pointer* columns,
+                         std::index_sequence<I...>) noexcept
 {
-  return from;
+  ((columns[I] = soa.template column<I>()), ...);
 }
 
-template <typename To, typename From>
-To cast_impl(From from, up_cast_tag)
+// 字段少时按记录逐条转换，编译器能把交错访问向量化
+static constexpr std::size_t soa_record_major_fields = 4;
+
+template <typename Policy, typename From, typename To, std::size_t... I>
+void aos_to_soa_records(const From* from, std::size_t count,
+                        struct_of_arrays<To>& to, std::index_sequence<I...>)
 {
-  return static_cast<To>(from);
+  using from_fields = aggregate_field_types_t<From>;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto fields = aggregate_tie(from[i]);
+    ((to.template column<I>()[i] = auto_cast_impl<
+          typename struct_of_arrays<To>::template field_type<I>,
+          std::tuple_element_t<I, from_fields>,
+          Policy>::cast(std::get<I>(fields))),
+     ...);
+  }
 }
 
-template <typename To, typename From>
-To cast_impl(From from, down_cast_polymorphic_tag)
+template <typename Policy, typename From, typename To, std::size_t... I>
+void soa_to_aos_records(const struct_of_arrays<From>& from, std::size_t count,
+                        To* to, std::index_sequence<I...>)
 {
-  auto result = dynamic_cast<To>(from);
-  if (!result && from) {
-    throw std::bad_cast();
+  using to_fields = aggregate_field_types_t<To>;
+  for (std::size_t i = 0; i < count; ++i) {
+    auto fields = aggregate_tie(to[i]);
+    ((std::get<I>(fields) = auto_cast_impl<
+          std::tuple_element_t<I, to_fields>,
+          typename struct_of_arrays<From>::template field_type<I>,
+          Policy>::cast(from.template column<I>()[i])),
+     ...);
   }
-  return result;
 }
 
-template <typename To, typename From>
-To cast_impl(From from, down_cast_non_polymorphic_tag)
+// 字段多时分块后逐个字段转换，每次只有一个写出（或读入）的列
+template <typename Policy, typename From, typename To, std::size_t... I>
+void aos_to_soa_fields(const From* from, std::size_t begin, std::size_t end,
+                       struct_of_arrays<To>& to, std::index_sequence<I...>)
 {
-  return static_cast<To>(from);
+  using from_fields = aggregate_field_types_t<From>;
+  (
+      [&] {
+        using from_field = std::tuple_element_t<I, from_fields>;
+        using to_field = typename struct_of_arrays<To>::template field_type<I>;
+        to_field* column = to.template column<I>();
+        for (std::size_t i = begin; i < end; ++i) {
+          column[i] = auto_cast_impl<to_field, from_field, Policy>::cast(
+              std::get<I>(aggregate_tie(from[i])));
+        }
+      }(),
+      ...);
 }
 
-template <typename To, typename From>
-To cast_impl(From from, const_removal_tag)
+template <typename Policy, typename From, typename To, std::size_t... I>
+void soa_to_aos_fields(const struct_of_arrays<From>& from, std::size_t begin,
+                       std::size_t end, To* to, std::index_sequence<I...>)
 {
-  return const_cast<To>(from);
+  using to_fields = aggregate_field_types_t<To>;
+  (
+      [&] {
+        using from_field =
+            typename struct_of_arrays<From>::template field_type<I>;
+        using to_field = std::tuple_element_t<I, to_fields>;
+        const from_field* column = from.template column<I>();
+        for (std::size_t i = begin; i < end; ++i) {
+          std::get<I>(aggregate_tie(to[i])) =
+              auto_cast_impl<to_field, from_field, Policy>::cast(column[i]);
+        }
+      }(),
+      ...);
 }
 
-template <typename To, typename From>
-To cast_impl(From from, standard_pointer_integer_tag)
+// 结构数组转为数组结构：to调整为count行，字段按位置逐个auto_cast
+// 字段多于4个、两边字段类型相同且都是4字节时直接做分块SIMD转置
+template <typename To, typename Policy = default_policy, typename From>
+void auto_cast_span(const From* from, struct_of_arrays<To>& to,
+                    std::size_t count)
 {
-  return reinterpret_cast<To>(from);
+  constexpr std::size_t fields = struct_of_arrays<To>::field_count;
+  static_assert(aggregate_field_count<From>() == fields,
+                "auto_cast_span<>: source and target records must have the "
+                "same number of fields");
+  to.resize(count);
+  if constexpr (fields <= soa_record_major_fields) {
+    aos_to_soa_records<Policy>(from, count, to,
+                               std::make_index_sequence<fields>{});
+  }
+  else if constexpr (is_soa_transpose_only<From, To>::value) {
+    void* columns[fields];
+    soa_column_pointers(to, columns, std::make_index_sequence<fields>{});
+    select_soa_transpose_kernels().rows_to_columns(from, count, fields,
+                                                   columns);
+  }
+  else {
+    const std::size_t block =
+        std::max<std::size_t>(1, soa_block_bytes / sizeof(From));
+    for (std::size_t begin = 0; begin < count; begin += block) {
+      aos_to_soa_fields<Policy>(from, begin, std::min(count, begin + block),
+                                to, std::make_index_sequence<fields>{});
+    }
+  }
 }
 
-template <typename To, typename From>
-To cast_impl(From from, generic_pointer_integer_tag)
+// 数组结构转回结构数组：to至少要有count条记录
+template <typename To, typename Policy = default_policy, typename From>
+void auto_cast_span(const struct_of_arrays<From>& from, To* to,
+                    std::size_t count)
 {
-  // Ƿ㹻
-  static_assert(
-      !(std::is_pointer<From>::value && std::is_integral<To>::value) ||
-          (sizeof(To) >= sizeof(void*)),
-      "Integer type is too small to hold a pointer");
-  return reinterpret_cast<To>(from);
+  constexpr std::size_t fields = struct_of_arrays<From>::field_count;
+  static_assert(aggregate_field_count<To>() == fields,
+                "auto_cast_span<>: source and target records must have the "
+                "same number of fields");
+  count = std::min(count, from.size());
+  if constexpr (fields <= soa_record_major_fields) {
+    soa_to_aos_records<Policy>(from, count, to,
+                               std::make_index_sequence<fields>{});
+  }
+  else if constexpr (is_soa_transpose_only<From, To>::value) {
+    const void* columns[fields];
+    soa_column_pointers(from, columns, std::make_index_sequence<fields>{});
+    select_soa_transpose_kernels().columns_to_rows(columns, count, fields, to);
+  }
+  else {
+    const std::size_t block =
+        std::max<std::size_t>(1, soa_block_bytes / sizeof(To));
+    for (std::size_t begin = 0; begin < count; begin += block) {
+      soa_to_aos_fields<Policy>(from, begin, std::min(count, begin + block),
+                                to, std::make_index_sequence<fields>{});
+    }
+  }
 }
 
-template <typename To, typename From>
-To cast_impl(From from, standard_conversion_tag)
+// 运行时才知道元素类型的列，以及按类型对预先生成的批量转换内核表
+enum class column_type : std::uint8_t
 {
-  return static_cast<To>(from);
+  int8,
+  int16,
+  int32,
+  int64,
+  uint8,
+  uint16,
+  uint32,
+  uint64,
+  float32,
+  float64
+};
+
+// 顺序与column_type一致
+using column_element_types =
+    std::tuple<std::int8_t, std::int16_t, std::int32_t, std::int64_t,
+               std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t,
+               float, double>;
+
+static constexpr std::size_t column_type_count =
+    std::tuple_size_v<column_element_types>;
+
+template <typename T, std::size_t I = 0>
+constexpr column_type column_type_of() noexcept
+{
+  if constexpr (std::is_same_v<T,
+                               std::tuple_element_t<I, column_element_types>>) {
+    return static_cast<column_type>(I);
+  }
+  else {
+    return column_type_of<T, I + 1>();
+  }
 }
 
-template <typename To, typename From>
-To cast_impl(From from, reinterpret_cast_tag)
+// 策略是否允许该类型对：有可用的转换，零开销策略下还必须是零开销的
+template <typename To, typename From, typename Policy>
+struct is_column_conversion_allowed
+    : std::bool_constant<auto_cast_traits<To, From, Policy>::kind !=
+                             cast_kind::invalid &&
+                         (!is_zero_overhead_policy<Policy>::value ||
+                          auto_cast_traits<To, From, Policy>::zero_overhead)>
 {
-  return reinterpret_cast<To>(from);
+};
+
+using column_kernel = void (*)(const void* from, void* to,
+                               std::size_t count) noexcept;
+
+// GCC在-O2下对未知长度的循环只做很保守的向量化，内核单独打开
+#if defined(__GNUC__) && !defined(__clang__)
+#define AUTO_CAST_VECTORIZE __attribute__((optimize("tree-vectorize")))
+#else
+#define AUTO_CAST_VECTORIZE
+#endif
+
+// 每个类型对一个内核，循环体内没有分派，由编译器按目标指令集向量化
+template <typename To, typename From, typename Policy>
+AUTO_CAST_VECTORIZE inline void convert_column_portable(
+    const void* from, void* to, std::size_t count) noexcept
+{
+  if constexpr (std::is_same_v<To, From>) {
+    std::memcpy(to, from, count * sizeof(To));
+  }
+  else {
+    const auto* source = static_cast<const From*>(from);
+    auto* target = static_cast<To*>(to);
+    for (std::size_t i = 0; i < count; ++i) {
+      target[i] = auto_cast_impl<To, From, Policy>::cast(source[i]);
+    }
+  }
 }
 
-template <typename To, typename From>
-To cast_impl(From /*unused*/, invalid_cast_tag /*unused*/)
+#ifdef AUTO_CAST_X86_SIMD
+template <typename To, typename From, typename Policy>
+__attribute__((target("avx2"))) AUTO_CAST_VECTORIZE inline void
+convert_column_avx2(const void* from, void* to, std::size_t count) noexcept
 {
-  static_assert(sizeof(To) == 0,
-                "auto_cast: No suitable conversion found between types");
-  using T = remove_cv_ptr_t<To>;
-  return T{};
+  const auto* source = static_cast<const From*>(from);
+  auto* target = static_cast<To*>(to);
+  for (std::size_t i = 0; i < count; ++i) {
+    target[i] = auto_cast_impl<To, From, Policy>::cast(source[i]);
+  }
 }
 
-template <typename To, typename From, typename Policy = default_policy>
-struct auto_cast_impl
+// AVX-512DQ提供64位整数与浮点之间的向量转换
+template <typename To, typename From, typename Policy>
+__attribute__((target("avx512f,avx512dq,avx512bw,avx512vl")))
+AUTO_CAST_VECTORIZE inline void
+convert_column_avx512(const void* from, void* to, std::size_t count) noexcept
 {
-  static To cast(From from)
-  {
-    using tag = typename get_cast_tag<To, From, Policy>::type;
-    return cast_impl<To, From>(from, tag{});
+  const auto* source = static_cast<const From*>(from);
+  auto* target = static_cast<To*>(to);
+  for (std::size_t i = 0; i < count; ++i) {
+    target[i] = auto_cast_impl<To, From, Policy>::cast(source[i]);
   }
+}
+#endif
+
+enum class column_kernel_isa
+{
+  portable,
+  avx2,
+  avx512
 };
 
+// 策略不允许的类型对不实例化内核，表项为空
+template <typename To, typename From, typename Policy, column_kernel_isa Isa>
+constexpr column_kernel column_kernel_for() noexcept
+{
+  if constexpr (!is_column_conversion_allowed<To, From, Policy>::value) {
+    return nullptr;
+  }
+  else if constexpr (std::is_same_v<To, From> ||
+                     Isa == column_kernel_isa::portable) {
+    return &convert_column_portable<To, From, Policy>;
+  }
+#ifdef AUTO_CAST_X86_SIMD
+  else if constexpr (Isa == column_kernel_isa::avx2) {
+    return &convert_column_avx2<To, From, Policy>;
+  }
+  else {
+    return &convert_column_avx512<To, From, Policy>;
+  }
+#else
+  else {
+    return &convert_column_portable<To, From, Policy>;
+  }
 #endif
+}
 
-// ûӿ - ģ
-template <typename To, typename Policy = default_policy, typename From>
-To auto_cast(From from)
+// 按[源类型][目标类型]展开的N×N内核表
+using column_kernel_table =
+    std::array<column_kernel, column_type_count * column_type_count>;
+
+template <typename Policy, column_kernel_isa Isa, std::size_t... I>
+constexpr column_kernel_table make_column_kernel_table(
+    std::index_sequence<I...>) noexcept
 {
-  return auto_cast_impl<To, From, Policy>::cast(from);
+  return {{column_kernel_for<
+      std::tuple_element_t<I % column_type_count, column_element_types>,
+      std::tuple_element_t<I / column_type_count, column_element_types>,
+      Policy, Isa>()...}};
 }
 
-// ݱ
-template <typename To, typename From>
-To auto_cast_safe(From from)
+template <typename Policy>
+const column_kernel_table& select_column_kernels() noexcept
 {
-  return auto_cast_impl<To, From, default_policy>::cast(from);
+  using indices =
+      std::make_index_sequence<column_type_count * column_type_count>;
+  static constexpr auto portable =
+      make_column_kernel_table<Policy, column_kernel_isa::portable>(indices{});
+#ifdef AUTO_CAST_X86_SIMD
+  static constexpr auto avx2 =
+      make_column_kernel_table<Policy, column_kernel_isa::avx2>(indices{});
+  static constexpr auto avx512 =
+      make_column_kernel_table<Policy, column_kernel_isa::avx512>(indices{});
+  static const column_kernel_table& selected =
+      []() -> const column_kernel_table& {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512dq") &&
+        __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl")) {
+      return avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return avx2;
+    }
+    return portable;
+  }();
+  return selected;
+#else
+  return portable;
+#endif
 }
 
-template <typename To, typename From>
-To auto_cast_unsafe(From from)
+// 策略是否允许在两种列类型之间转换
+template <typename Policy = default_policy>
+bool column_conversion_allowed(column_type from_type,
+                               column_type to_type) noexcept
 {
-  return auto_cast_impl<To, From, unsafe_policy>::cast(from);
+  const auto from_index = static_cast<std::size_t>(from_type);
+  const auto to_index = static_cast<std::size_t>(to_type);
+  return from_index < column_type_count && to_index < column_type_count &&
+         select_column_kernels<Policy>()[from_index * column_type_count +
+                                         to_index] != nullptr;
 }
 
-template <typename To, typename From>
-To auto_cast_strict(From from)
+// 整列转换：只查一次内核表，策略不允许的类型对返回false且不写入to
+template <typename Policy = default_policy>
+bool convert_column(column_type from_type, column_type to_type,
+                    const void* from, void* to, std::size_t count) noexcept
 {
-  return auto_cast_impl<To, From, strict_policy>::cast(from);
+  const auto from_index = static_cast<std::size_t>(from_type);
+  const auto to_index = static_cast<std::size_t>(to_type);
+  if (from_index >= column_type_count || to_index >= column_type_count) {
+    return false;
+  }
+  const column_kernel kernel =
+      select_column_kernels<Policy>()[from_index * column_type_count +
+                                      to_index];
+  if (!kernel) {
+    return false;
+  }
+  kernel(from, to, count);
+  return true;
 }
 
-#if CPP_17
-// ʱ汾,std::optional
-template <typename To, typename From, typename Policy = default_policy>
-std::optional<To> try_auto_cast(From from) noexcept
+#if CPP_20
+// 逐元素转换的函数对象，供惰性视图使用
+template <typename To, typename Policy = default_policy>
+struct auto_cast_fn
 {
-  try {
+  template <typename From>
+  To operator()(const From& from) const
+  {
     return auto_cast_impl<To, From, Policy>::cast(from);
-  } catch (const std::bad_cast&) {
-    return std::nullopt;
-  } catch (...) {
-    return std::nullopt;
   }
-}
-#else
-// ʱ汾,ؿն
-template <typename To, typename From, typename Policy = default_policy>
-To try_auto_cast(From from) noexcept
+};
+
+// 惰性转换视图：迭代时逐个auto_cast，不分配内存，可与其他视图组合
+template <std::ranges::view V, typename To, typename Policy = default_policy>
+class cast_view : public std::ranges::view_interface<cast_view<V, To, Policy>>
 {
-  try {
-    return auto_cast_impl<To, From, Policy>::cast(from);
-  } catch (const std::bad_cast&) {
-    return To{};
-  } catch (...) {
-    return To{};
+  using transform_type =
+      std::ranges::transform_view<V, auto_cast_fn<To, Policy>>;
+
+public:
+  cast_view() = default;
+  explicit cast_view(V base) : view_(std::move(base), auto_cast_fn<To, Policy>{})
+  {
+  }
+
+  auto begin() { return view_.begin(); }
+  auto end() { return view_.end(); }
+  auto begin() const
+    requires std::ranges::range<const transform_type>
+  {
+    return view_.begin();
+  }
+  auto end() const
+    requires std::ranges::range<const transform_type>
+  {
+    return view_.end();
+  }
+  auto size()
+    requires std::ranges::sized_range<transform_type>
+  {
+    return view_.size();
+  }
+  auto size() const
+    requires std::ranges::sized_range<const transform_type>
+  {
+    return view_.size();
+  }
+
+  V base() const& { return view_.base(); }
+
+  // 按块交给下游处理：底层连续时用auto_cast_span批量转换（可使用SIMD内核），
+  // 否则逐个转换填满块；块缓冲区位于栈上
+  template <std::size_t ChunkSize = 256, typename Consumer>
+  void for_each_chunk(Consumer&& consumer)
+  {
+    To buffer[ChunkSize];
+    if constexpr (std::ranges::contiguous_range<V> &&
+                  std::ranges::sized_range<V>) {
+      const auto* data = std::to_address(view_.begin().base());
+      const std::size_t total = std::ranges::size(view_);
+      for (std::size_t offset = 0; offset < total; offset += ChunkSize) {
+        const std::size_t count = std::min(ChunkSize, total - offset);
+        auto_cast_span<To, Policy>(data + offset, buffer, count);
+        std::invoke(consumer, std::span<const To>(buffer, count));
+      }
+    }
+    else {
+      std::size_t count = 0;
+      for (auto&& value : view_) {
+        buffer[count++] = value;
+        if (count == ChunkSize) {
+          std::invoke(consumer, std::span<const To>(buffer, count));
+          count = 0;
+        }
+      }
+      if (count > 0) {
+        std::invoke(consumer, std::span<const To>(buffer, count));
+      }
+    }
+  }
+
+private:
+  transform_type view_;
+};
+
+// 管道适配器：range | auto_cast_view<To>()
+template <typename To, typename Policy = default_policy>
+struct cast_view_adaptor
+{
+  template <std::ranges::viewable_range R>
+  friend auto operator|(R&& range, cast_view_adaptor)
+  {
+    return cast_view<std::views::all_t<R>, To, Policy>(
+        std::views::all(std::forward<R>(range)));
   }
+};
+
+template <typename To, typename Policy = default_policy,
+          std::ranges::viewable_range R>
+auto auto_cast_view(R&& range)
+{
+  return cast_view<std::views::all_t<R>, To, Policy>(
+      std::views::all(std::forward<R>(range)));
 }
 
+template <typename To, typename Policy = default_policy>
+cast_view_adaptor<To, Policy> auto_cast_view()
+{
+  return {};
+}
 #endif
@@ -1,11 +1,18 @@
 #include "../inc/auto_cast.hpp"
 
 #include <cstdint>
+#include <cstring>
 
 #include <iostream>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <vector>
 
 
-// ʹʾ
+// 使用示例
 class Base
 {
 public:
@@ -19,6 +26,16 @@ public:
   void foo() override { std::cout << "Derived::foo()\n"; }
 };
 
+class OtherDerived : public Base
+{
+public:
+  void foo() override { std::cout << "OtherDerived::foo()\n"; }
+};
+
+class MoreDerived : public Derived
+{
+};
+
 class NonPolymorphicBase
 {
 };
@@ -27,117 +44,601 @@ class NonPolymorphicDerived : public NonPolymorphicBase
 {
 };
 
-// Զ
+// 自定义策略
 struct my_policy
 {
   using tag = safe_cast_tag;
-  static constexpr bool allow_reinterpret = false;               // ֹreinterpret
-  static constexpr bool allow_const_removal = true;              // ȥconst
-  static constexpr bool allow_non_polymorphic_downcast = false;  // ֹǶ̬ת
+  static constexpr bool allow_reinterpret = false;               // 禁止reinterpret
+  static constexpr bool allow_const_removal = true;              // 允许去const
+  static constexpr bool allow_non_polymorphic_downcast = false;  // 禁止非多态向下转换
   static constexpr bool allow_standard_pointer_integer_cast = true;
 };
 
 void demonstrate_different_policies()
 {
-  std::cout << "=== ʾͬԵauto_cast ===\n";
+  std::cout << "=== 演示不同策略的auto_cast ===\n";
 
-  // 1. Ĭϲԣȫģʽ
-  std::cout << "1. Ĭϲԣȫģʽ:"<<"\n";
+  // 1. 默认策略（安全模式）
+  std::cout << "1. 默认策略（安全模式）:"<<"\n";
 
   int x = 42;
   int* ptr = &x;
   
 
-  // ȫģʽת
-  uintptr_t int_ptr1 = auto_cast<uintptr_t>(ptr);  // ׼ת
-  std::cout << "   ׼ת: " << int_ptr1 << "\n";
+  // 安全模式允许的转换
+  uintptr_t int_ptr1 = auto_cast<uintptr_t>(ptr);  // 标准转换
+  std::cout << "   标准转换: " << int_ptr1 << "\n";
 
-  // ȫģʽֹreinterpret_cast
-  // ´ڱʱᱨ
-  // int* ptr2 = auto_cast<int*>(int_ptr1);  // 󣺲reinterpret_cast
+  // 安全模式禁止reinterpret_cast
+  // 以下代码在编译时会报错：
+  // int* ptr2 = auto_cast<int*>(int_ptr1);  // 错误：不允许reinterpret_cast
 
-  // 2. ȫģʽ
-  std::cout << "\n2. ȫģʽ:\n";
+  // 2. 不安全模式
+  std::cout << "\n2. 不安全模式:\n";
 
-  // ȷʹòȫģʽ
+  // 明确使用不安全模式
   int* ptr3 = auto_cast<int*, unsafe_policy>(int_ptr1);
-  std::cout << "   reinterpret_cast: ptr3 = " << ptr3 << "\n";
+  std::cout << "   reinterpret_cast允许: ptr3 = " << ptr3 << "\n";
 
-  // ʹñݱ
+  // 或者使用便捷别名
   int* ptr4 = auto_cast_unsafe<int*>(int_ptr1);
-  std::cout << "   ݱ: ptr4 = " << ptr4 << "\n";
+  std::cout << "   便捷别名: ptr4 = " << ptr4 << "\n";
 
-  // 3. ϸģʽ
-  std::cout << "\n3. ϸģʽ:\n";
+  // 3. 严格模式
+  std::cout << "\n3. 严格模式:\n";
 
   int y = 100;
-  // ϸģʽת
-  std::int16_t int_y = auto_cast<int>(y);  // ûȥconst
-  std::cout << "   ׼ת: " << int_y << "\n";
+  // 严格模式允许的转换
+  std::int16_t int_y = auto_cast<int>(y);  // 允许，没有去const
+  std::cout << "   标准转换: " << int_y << "\n";
 
-  // ϸģʽֹת
-  // ´ڱʱᱨ
-  // int& ref_y = auto_cast_strict<int&>(y);  // 󣺲ȥconst
+  // 严格模式禁止的转换
+  // 以下代码在编译时会报错：
+  // int& ref_y = auto_cast_strict<int&>(y);  // 错误：不允许去const
 
-  // 4. Ƕ̬ת
-  std::cout << "\n4. Ƕ̬ת:\n";
+  // 4. 非多态向下转换
+  std::cout << "\n4. 非多态向下转换:\n";
 
   NonPolymorphicDerived npd;
   NonPolymorphicBase* npb = &npd;
 
-  // ȫģʽ
+  // 不安全模式允许
   NonPolymorphicDerived* npd2 = auto_cast<NonPolymorphicDerived*,unsafe_policy>(npb);
-  std::cout << "   ȫģʽǶ̬ת\n";
-  //ȫģʽ²Ƕ̬ת,ΪһΪһǲȫ
+  std::cout << "   不安全模式允许非多态向下转换\n";
+  //安全模式下不允许非多态向下转换,因为这一行为一般是不安全的
 
-  // ϸģʽֹ
-  // ´ڱʱᱨ
+  // 严格模式禁止
+  // 以下代码在编译时会报错：
   // NonPolymorphicDerived* npd3 =
   //    auto_cast_strict<NonPolymorphicDerived*>(npb);  //
-  //     󣺲Ƕ̬ת
+  //     错误：不允许非多态向下转换
 
-  // 5. ʱȫ汾
-  std::cout << "\n5. ʱȫ汾:\n";
+  // 5. 运行时安全版本
+  std::cout << "\n5. 运行时安全版本:\n";
 
   Base* base = new Derived();
 
-  // cpp17,ʹtry_auto_castoptional
+  // cpp17及以上,使用try_auto_cast，返回optional
   #if CPP_17
   if (auto derived = try_auto_cast<Derived*>(base)) {
-    std::cout << "   תɹ\n";
+    std::cout << "   转换成功\n";
     (*derived)->foo();
   }
   #else
   if (auto derived = try_auto_cast<Derived*>(base)) {
-    std::cout << "   תɹ\n"<<"\n";
+    std::cout << "   转换成功\n"<<"\n";
     derived->foo();
   }
 #endif
 
-  // ת
+  // 错误的向下转换
   Base* base2 = new Base();
   if (auto derived2 = try_auto_cast<Derived*>(base2)) {
-    std::cout << "   תɹӦôӡ\n";
+    std::cout << "   转换成功（不应该打印）\n";
   }
   else {
-    std::cout << "   תʧܣؿն\n";
+    std::cout << "   转换失败，返回空对象\n";
   }
 
-  // 6. ͬԵ
-  std::cout << "\n6. ʾ:\n";
+  // 6. 不同策略的组合
+  std::cout << "\n6. 策略组合示例:\n";
 
   
 
   const int z = 200;
   int ref_z = auto_cast<int, my_policy>(z);
-  std::cout << "   ԶԣȥconstֹreinterpretͷǶ̬ת:"<<ref_z<<"\n";
+  std::cout << "   自定义策略：允许去const，禁止reinterpret和非多态向下转换:"<<ref_z<<"\n";
+
+  // 7. 调试检查模式
+  std::cout << "\n7. 调试检查模式:\n";
+
+  // 调试版本用dynamic_cast并断言，定义NDEBUG后为零开销的static_cast
+  Derived* checked = auto_cast_checked<Derived*>(base);
+  std::cout << "   检查向下转换: ";
+  checked->foo();
+
+  // 8. 零开销模式与转换特征
+  std::cout << "\n8. 零开销模式:\n";
+
+  static_assert(auto_cast_traits<Base*, Derived*>::zero_overhead,
+                "向上转换只需要偏移调整");
+  static_assert(auto_cast_traits<Derived*, Base*>::uses_rtti,
+                "多态向下转换使用dynamic_cast");
+  Base* zero_cost = auto_cast<Base*, zero_overhead_policy>(checked);
+  // auto_cast<Derived*, zero_overhead_policy>(base);  // 错误：需要RTTI
+  std::cout << "   向上转换可能抛出异常: "
+            << !auto_cast_traits<Base*, Derived*>::is_noexcept
+            << ", 向下转换可能抛出异常: "
+            << !auto_cast_traits<Derived*, Base*>::is_noexcept << "\n";
+  zero_cost->foo();
 
   delete base;
   delete base2;
 }
 
+struct ListNode
+{
+  long value;
+  tagged_ptr<ListNode, 3> next;
+};
+
+struct CompactNode
+{
+  int value;
+  compressed_ptr<CompactNode> next;
+};
+
+void demonstrate_packed_pointers()
+{
+  std::cout << "\n=== 带标签指针与压缩指针 ===\n";
+
+  ListNode second{2, {}};
+  ListNode first{1, auto_cast<tagged_ptr<ListNode, 3>>(&second)};
+  first.next.set_tag(5);
+  ListNode* next = auto_cast<ListNode*>(first.next);  // 丢弃标签位
+  std::cout << "   标签: " << first.next.tag() << " 下一个: " << next->value
+            << "\n";
+  // auto_cast_strict<ListNode*>(first.next);  // 错误：严格模式禁止丢弃标签位
+
+  std::vector<CompactNode> pool(16);
+  compressed_heap::set_base(pool.data());
+  pool[0].next = auto_cast<compressed_ptr<CompactNode>>(&pool[7]);
+  std::cout << "   压缩指针: " << sizeof(pool[0].next)
+            << " 字节, 节点: " << sizeof(CompactNode) << " 字节, 还原正确: "
+            << (auto_cast<CompactNode*>(pool[0].next) == &pool[7]) << "\n";
+}
+
+// 可以整体复制或映射到任意地址的数据
+// 映射区只能存放平凡可复制的数据：按字节复制多态对象是未定义行为
+struct MappedHeader
+{
+  int kind = 1;
+};
+
+struct MappedRecord : MappedHeader
+{
+  int payload = 42;
+};
+
+struct MappedIndex
+{
+  MappedRecord root;
+  offset_ptr<MappedHeader> entry;
+};
+static_assert(std::is_trivially_copyable_v<MappedRecord>,
+              "映射区中的数据必须可以按字节复制");
+// offset_ptr的复制会重新计算偏移，但其字节表示与地址无关，可以随映射区整体移动
+static_assert(std::is_trivially_destructible_v<MappedIndex>,
+              "映射区索引必须无需析构");
+
+void demonstrate_offset_pointers()
+{
+  std::cout << "\n=== 自相对指针 ===\n";
+
+  alignas(MappedIndex) unsigned char image[sizeof(MappedIndex)];
+  alignas(MappedIndex) unsigned char mapped[sizeof(MappedIndex)];
+  auto* index = new (image) MappedIndex();
+  index->entry = auto_cast<offset_ptr<MappedHeader>>(&index->root);  // 向上转换
+
+  // 模拟mmap：按字节复制到另一个地址后直接使用
+  std::memcpy(mapped, image, sizeof(MappedIndex));
+  auto* view = reinterpret_cast<MappedIndex*>(mapped);
+  MappedHeader* root = auto_cast<MappedHeader*>(view->entry);
+  std::cout << "   映射后仍指向映射内的对象: " << (root == &view->root)
+            << ", kind = " << root->kind << "\n";
+}
+
+void demonstrate_half_precision()
+{
+  std::cout << "\n=== 半精度浮点 ===\n";
+
+  float16 h = auto_cast<float16>(3.14159f);
+  bfloat16 b = auto_cast<bfloat16>(h);
+  std::cout << "   float16: " << auto_cast<float>(h)
+            << " bfloat16: " << auto_cast<float>(b) << "\n";
+
+  float values[] = {0.5f, -1.25f, 65504.0f, 1e6f};
+  float16 packed[4];
+  float restored[4];
+  auto_cast_span<float16>(values, packed, 4);
+  auto_cast_span<float>(packed, restored, 4);
+  std::cout << "   批量转换:";
+  for (float value : restored) {
+    std::cout << " " << value;
+  }
+  std::cout << "\n";
+
+  // 超过53位的整数：转double时丢弃的低位也参与舍入，结果只舍入一次
+  const std::int64_t wide =
+      (std::int64_t(1) << 62) + (std::int64_t(1) << 54) + 1;
+  const bfloat16 rounded = auto_cast<bfloat16>(wide);
+  std::cout << "   2^62+2^54+1 -> bfloat16: 0x" << std::hex << rounded.bits
+            << std::dec
+            << (rounded.bits == 0x5e81 ? "（正确）" : "（二次舍入）") << "\n";
+}
+
+struct SensorSample
+{
+  std::int32_t id;
+  float temperature;
+  float humidity;
+};
+
+struct SensorColumns
+{
+  std::int64_t id;
+  double temperature;
+  double humidity;
+};
+
+void demonstrate_struct_of_arrays()
+{
+  std::cout << "\n=== 结构数组与数组结构 ===\n";
+
+  SensorSample samples[] = {{1, 21.5f, 0.40f}, {2, 22.0f, 0.45f},
+                            {3, 19.75f, 0.50f}};
+  // 按列存储，字段逐个按策略转换为更宽的类型
+  struct_of_arrays<SensorColumns> columns;
+  auto_cast_span(samples, columns, 3);
+  std::cout << "   temperature列:";
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    std::cout << " " << columns.column<1>()[i];
+  }
+  std::cout << "\n";
+
+  SensorSample restored[3];
+  auto_cast_span(columns, restored, 3);
+  std::cout << "   还原第3条: id=" << restored[2].id
+            << " humidity=" << restored[2].humidity << "\n";
+}
+
+void demonstrate_column_conversion()
+{
+  std::cout << "\n=== 运行时类型的列转换 ===\n";
+
+  // 列类型来自查询计划，编译时未知
+  column_type from_type = column_type::int32;
+  column_type to_type = column_type::float64;
+  std::int32_t ids[] = {10, 20, 30, 40};
+  double converted[4];
+  if (convert_column(from_type, to_type, ids, converted, 4)) {
+    std::cout << "   int32 -> float64:";
+    for (double value : converted) {
+      std::cout << " " << value;
+    }
+    std::cout << "\n";
+  }
+
+  // 零开销策略不允许整数与浮点之间的转换
+  std::cout << "   零开销策略 int32 -> float64: "
+            << (convert_column<zero_overhead_policy>(from_type, to_type, ids,
+                                                     converted, 4)
+                    ? "允许"
+                    : "不允许")
+            << "\n";
+}
+
+void demonstrate_callables()
+{
+  std::cout << "\n=== 可调用对象转换 ===\n";
+
+  // 无捕获lambda直接转为函数指针，不经过std::function
+  auto square = [](int x) { return x * x; };
+  int (*callback)(int) = auto_cast<int (*)(int), strict_policy>(square);
+  std::cout << "   函数指针: " << callback(7) << "\n";
+
+  // 有捕获的lambda转为不拥有对象的function_ref
+  int offset = 100;
+  auto shifted = [&offset](int x) { return x + offset; };
+  function_ref<int(int)> ref = auto_cast<function_ref<int(int)>>(shifted);
+  offset = 200;
+  std::cout << "   function_ref: " << ref(1) << "\n";
+}
+
+// 内部记录与线上记录，price和quantity的类型不同
+struct OrderRecord
+{
+  std::int64_t id;
+  std::int32_t account;
+  std::int32_t flags;
+  double price;
+  float quantity;
+};
+
+struct WireOrder
+{
+  std::int64_t id;
+  std::int32_t account;
+  std::int32_t flags;
+  float price;
+  double quantity;
+};
+
+// 只保留价格和编号，顺序不同
+struct OrderSummary
+{
+  double price;
+  std::int64_t id;
+};
+
+template <>
+struct aggregate_field_mapping<WireOrder, OrderRecord>
+    : positional_field_mapping
+{
+};
+
+template <>
+struct aggregate_field_mapping<OrderSummary, OrderRecord> : field_mapping<3, 0>
+{
+};
+
+void demonstrate_aggregate_cast()
+{
+  std::cout << "\n=== 聚合体逐字段转换 ===\n";
+
+  OrderRecord order{42, 7, 1, 99.5, 3.0f};
+  // id、account、flags合并为一次memcpy，其余字段按策略转换
+  WireOrder wire = auto_cast<WireOrder>(order);
+  std::cout << "   线上记录: id=" << wire.id << " price=" << wire.price
+            << " quantity=" << wire.quantity << "\n";
+
+  OrderSummary summary = auto_cast<OrderSummary, strict_policy>(order);
+  std::cout << "   摘要: price=" << summary.price << " id=" << summary.id
+            << "\n";
+
+  OrderRecord batch[] = {order, {43, 7, 0, 100.25, 1.5f}};
+  WireOrder wires[2];
+  auto_cast_span<WireOrder>(batch, wires, 2);
+  std::cout << "   批量转换第2条: id=" << wires[1].id
+            << " price=" << wires[1].price << "\n";
+}
+
+void demonstrate_unicode()
+{
+  std::cout << "\n=== Unicode转码 ===\n";
+
+  // 来自Windows的UTF-16文本转为UTF-8
+  const std::u16string_view title = u"\u81ea\u52a8\u8f6c\u6362 auto_cast";
+  std::string utf8 = auto_cast<std::string>(title);
+  std::cout << "   UTF-8: " << utf8 << " (" << utf8.size() << "字节)\n";
+
+  std::u32string code_points =
+      auto_cast<std::u32string>(std::string_view(utf8));
+  std::cout << "   码点数: " << code_points.size() << "\n";
+
+  // 截断的多字节序列
+  std::optional<std::u16string> broken =
+      try_auto_cast<std::u16string>(std::string_view(utf8.data(), 2));
+  std::cout << "   截断的UTF-8: " << (broken ? "转换成功" : "转换失败") << "\n";
+}
+
+#if CPP_20
+void demonstrate_cast_view()
+{
+  std::cout << "\n=== 惰性转换视图 ===\n";
+
+  std::vector<float> samples{0.5f, 1.5f, -2.0f, 3.25f, 8.0f};
+  // 与其他视图组合，迭代时才转换，不产生中间容器
+  auto positive = samples |
+                  std::views::filter([](float value) { return value > 0; }) |
+                  auto_cast_view<double>();
+  double sum = 0;
+  for (double value : positive) {
+    sum += value;
+  }
+  std::cout << "   正数之和: " << sum << "\n";
+
+  // 连续数据按块批量转换
+  std::size_t chunks = 0;
+  auto_cast_view<float16>(samples).for_each_chunk<2>(
+      [&](std::span<const float16> chunk) { chunks += !chunk.empty(); });
+  std::cout << "   块数: " << chunks << "\n";
+}
+#endif
+
+#if CPP_17
+// Derived在Replicated中出现两次：能否转为Derived*取决于传入的是哪个Base子对象
+class LeftPath : public Derived
+{
+};
+
+class RightPath : public Derived
+{
+};
+
+class SideChannel : public Base
+{
+};
+
+class Replicated : public LeftPath, public RightPath, public SideChannel
+{
+};
+
+void demonstrate_auto_cast_switch()
+{
+  std::cout << "\n=== 多目标向下转换 auto_cast_switch ===\n";
+
+  Derived derived;
+  OtherDerived other;
+  MoreDerived more;
+  Base plain;
+  Base* objects[] = {&derived, &other, &more, &plain, nullptr};
+
+  for (Base* object : objects) {
+    const char* name = auto_cast_switch<Derived*, OtherDerived*>(
+        object, [](Derived*) { return "Derived"; },
+        [](OtherDerived*) { return "OtherDerived"; },
+        [](Base*) { return "未匹配"; });
+    std::cout << "   下标 " << auto_cast_index<Derived*, OtherDerived*>(object)
+              << ": " << name << "\n";
+  }
+
+  // 同一动态类型的不同子对象交替传入，缓存不能混用两者的结果
+  Replicated replicated;
+  Base* left_side = static_cast<Derived*>(static_cast<LeftPath*>(&replicated));
+  Base* channel_side = static_cast<SideChannel*>(&replicated);
+  Base* sides[] = {left_side, channel_side, left_side, channel_side};
+  for (Base* side : sides) {
+    const char* name = auto_cast_switch<Derived*, OtherDerived*>(
+        side, [](Derived* d) { return d ? "Derived" : "空指针"; },
+        [](OtherDerived*) { return "OtherDerived"; },
+        [](Base*) { return "未匹配"; });
+    std::cout << "   重复基类 "
+              << (side == left_side ? "LeftPath侧" : "SideChannel侧") << ": "
+              << name << "\n";
+  }
+}
+#endif
+
+// 按类型分布推测的向下转换：正常情况下特化来自write_down_cast_profile生成的头文件，
+// 这里直接写出，表示Event -> MouseEvent的转换点最常见的动态类型是MouseEvent和DoubleClick
+class Event
+{
+public:
+  virtual ~Event() = default;
+};
+
+class KeyEvent : public Event
+{
+};
+
+class MouseEvent : public Event
+{
+public:
+  int x = 3;
+};
+
+class DoubleClick : public MouseEvent
+{
+};
+
+class Drag : public MouseEvent
+{
+};
+
+template <>
+struct down_cast_profile<MouseEvent, Event>
+{
+  using expected = std::tuple<MouseEvent, DoubleClick>;
+};
+
+void demonstrate_down_cast_profile()
+{
+  std::cout << "\n=== 按类型分布推测的向下转换 ===\n";
+
+  MouseEvent mouse;
+  DoubleClick double_click;
+  Drag drag;
+  KeyEvent key;
+  struct sample
+  {
+    const char* label;
+    Event* event;
+    MouseEvent* expected;
+  };
+  // 预测命中时只比较typeid再static_cast；未预测的派生类型回退到dynamic_cast；
+  // 类型不符时与dynamic_cast一样失败，try_auto_cast返回空
+  const sample samples[] = {{"预测命中 MouseEvent", &mouse, &mouse},
+                            {"预测命中 DoubleClick", &double_click,
+                             &double_click},
+                            {"未预测 Drag", &drag, &drag},
+                            {"类型不符 KeyEvent", &key, nullptr},
+                            {"空指针", nullptr, nullptr}};
+  for (const sample& s : samples) {
+    MouseEvent* result = try_auto_cast<MouseEvent*>(s.event).value_or(nullptr);
+    std::cout << "   " << s.label << ": "
+              << (result == s.expected ? "结果正确" : "结果错误")
+              << (result ? "" : "（空指针）") << "\n";
+  }
+}
+
+void demonstrate_conversion_registry()
+{
+  std::cout << "\n=== 运行时转换注册表 ===\n";
+
+  conversion_registry registry;
+  registry.add<double, int>();
+  registry.add<Derived*, Base*>();
+
+  // 类型只在运行时已知，例如从反序列化数据中读出
+  std::type_index from = typeid(int);
+  std::type_index to = typeid(double);
+  int number = 42;
+  double result = 0.0;
+  if (registry.convert(from, to, &number, &result)) {
+    std::cout << "   int -> double: " << result << "\n";
+  }
+
+  Derived derived;
+  Base plain;
+  Base* sources[] = {&derived, &plain};
+  for (Base* source : sources) {
+    Derived* target = nullptr;
+    bool ok = registry.convert(typeid(Base*), typeid(Derived*), &source,
+                               &target);
+    std::cout << "   Base* -> Derived*: " << (ok && target ? "成功" : "失败")
+              << "\n";
+  }
+
+  // 注册的转码遇到非法输入时返回false而不是抛出unicode_error
+  registry.add<std::u16string, std::string_view>();
+  const std::string_view texts[] = {"auto_cast", "\xe8\x87"};
+  for (std::string_view text : texts) {
+    std::u16string utf16;
+    bool ok = registry.convert(typeid(std::string_view), typeid(std::u16string),
+                               &text, &utf16);
+    std::cout << "   string_view -> u16string: " << (ok ? "成功" : "失败")
+              << "\n";
+  }
+
+  std::cout << "   未注册的类型对: "
+            << (registry.find(typeid(float), typeid(int)) ? "找到" : "未找到")
+            << "\n";
+}
+
 int main()
 {
   demonstrate_different_policies();
+  demonstrate_packed_pointers();
+  demonstrate_offset_pointers();
+  demonstrate_half_precision();
+  demonstrate_struct_of_arrays();
+  demonstrate_column_conversion();
+  demonstrate_callables();
+  demonstrate_aggregate_cast();
+  demonstrate_unicode();
+#if CPP_20
+  demonstrate_cast_view();
+#endif
+#if CPP_17
+  demonstrate_auto_cast_switch();
+#endif
+  demonstrate_down_cast_profile();
+  demonstrate_conversion_registry();
+#ifdef AUTO_CAST_RECORD_DOWN_CAST_PROFILE
+  // 记录模式：输出本次运行的向下转换类型分布
+  std::cout << "\n";
+  write_down_cast_profile(std::cout);
+#endif
   return 0;
 }
\ No newline at end of file
@@ -9,6 +9,48 @@ target("auto_cast_test")
     set_kind("binary")
     add_files("src/main.cpp")
     add_packages("auto_cast")
+
+target("half_precision_bench")
+    set_kind("binary")
+    set_languages("c++17")
+    set_optimize("fastest")
+    add_files("bench/half_precision_bench.cpp")
+
+target("conversion_registry_bench")
+    set_kind("binary")
+    set_languages("c++17")
+    set_optimize("fastest")
+    add_files("bench/conversion_registry_bench.cpp")
+
+target("soa_transpose_bench")
+    set_kind("binary")
+    set_languages("c++17")
+    set_optimize("fastest")
+    add_files("bench/soa_transpose_bench.cpp")
+
+target("column_conversion_bench")
+    set_kind("binary")
+    set_languages("c++17")
+    set_optimize("fastest")
+    add_files("bench/column_conversion_bench.cpp")
+
+target("callable_bench")
+    set_kind("binary")
+    set_languages("c++17")
+    set_optimize("fastest")
+    add_files("bench/callable_bench.cpp")
+
+target("aggregate_cast_bench")
+    set_kind("binary")
+    set_languages("c++17")
+    set_optimize("fastest")
+    add_files("bench/aggregate_cast_bench.cpp")
+
+target("unicode_transcode_bench")
+    set_kind("binary")
+    set_languages("c++17")
+    set_optimize("fastest")
+    add_files("bench/unicode_transcode_bench.cpp")
 --
 -- If you want to known more usage about xmake, please see https://xmake.io
 --